@@ -8,7 +8,6 @@ C_SRCS += \
 ../freertos/event_groups.c \
 ../freertos/fsl_tickless_lptmr.c \
 ../freertos/fsl_tickless_systick.c \
-../freertos/heap_4.c \
 ../freertos/list.c \
 ../freertos/port.c \
 ../freertos/queue.c \
@@ -20,7 +19,6 @@ C_DEPS += \
 ./freertos/event_groups.d \
 ./freertos/fsl_tickless_lptmr.d \
 ./freertos/fsl_tickless_systick.d \
-./freertos/heap_4.d \
 ./freertos/list.d \
 ./freertos/port.d \
 ./freertos/queue.d \
@@ -32,7 +30,6 @@ OBJS += \
 ./freertos/event_groups.o \
 ./freertos/fsl_tickless_lptmr.o \
 ./freertos/fsl_tickless_systick.o \
-./freertos/heap_4.o \
 ./freertos/list.o \
 ./freertos/port.o \
 ./freertos/queue.o \
@@ -52,7 +49,7 @@ freertos/%.o: ../freertos/%.c freertos/subdir.mk
 clean: clean-freertos
 
 clean-freertos:
-	-$(RM) ./freertos/croutine.d ./freertos/croutine.o ./freertos/event_groups.d ./freertos/event_groups.o ./freertos/fsl_tickless_lptmr.d ./freertos/fsl_tickless_lptmr.o ./freertos/fsl_tickless_systick.d ./freertos/fsl_tickless_systick.o ./freertos/heap_4.d ./freertos/heap_4.o ./freertos/list.d ./freertos/list.o ./freertos/port.d ./freertos/port.o ./freertos/queue.d ./freertos/queue.o ./freertos/tasks.d ./freertos/tasks.o ./freertos/timers.d ./freertos/timers.o
+	-$(RM) ./freertos/croutine.d ./freertos/croutine.o ./freertos/event_groups.d ./freertos/event_groups.o ./freertos/fsl_tickless_lptmr.d ./freertos/fsl_tickless_lptmr.o ./freertos/fsl_tickless_systick.d ./freertos/fsl_tickless_systick.o ./freertos/list.d ./freertos/list.o ./freertos/port.d ./freertos/port.o ./freertos/queue.d ./freertos/queue.o ./freertos/tasks.d ./freertos/tasks.o ./freertos/timers.d ./freertos/timers.o
 
 .PHONY: clean-freertos
 
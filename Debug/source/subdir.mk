@@ -4,31 +4,70 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../source/config.c \
+../source/filter.c \
 ../source/i2c.c \
 ../source/led.c \
+../source/lidar.c \
+../source/log.c \
 ../source/main.c \
+../source/memwatch.c \
 ../source/mtb.c \
+../source/perf.c \
+../source/pipeline.c \
+../source/power.c \
+../source/replay.c \
+../source/runtime.c \
 ../source/semihost_hardfault.c \
 ../source/task.c \
-../source/touch.c 
+../source/touch.c \
+../source/trace.c \
+../source/ttc.c \
+../source/zone.c 
 
 C_DEPS += \
+./source/config.d \
+./source/filter.d \
 ./source/i2c.d \
 ./source/led.d \
+./source/lidar.d \
+./source/log.d \
 ./source/main.d \
+./source/memwatch.d \
 ./source/mtb.d \
+./source/perf.d \
+./source/pipeline.d \
+./source/power.d \
+./source/replay.d \
+./source/runtime.d \
 ./source/semihost_hardfault.d \
 ./source/task.d \
-./source/touch.d 
+./source/touch.d \
+./source/trace.d \
+./source/ttc.d \
+./source/zone.d 
 
 OBJS += \
+./source/config.o \
+./source/filter.o \
 ./source/i2c.o \
 ./source/led.o \
+./source/lidar.o \
+./source/log.o \
 ./source/main.o \
+./source/memwatch.o \
 ./source/mtb.o \
+./source/perf.o \
+./source/pipeline.o \
+./source/power.o \
+./source/replay.o \
+./source/runtime.o \
 ./source/semihost_hardfault.o \
 ./source/task.o \
-./source/touch.o 
+./source/touch.o \
+./source/trace.o \
+./source/ttc.o \
+./source/zone.o 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -43,7 +82,7 @@ source/%.o: ../source/%.c source/subdir.mk
 clean: clean-source
 
 clean-source:
-	-$(RM) ./source/i2c.d ./source/i2c.o ./source/led.d ./source/led.o ./source/main.d ./source/main.o ./source/mtb.d ./source/mtb.o ./source/semihost_hardfault.d ./source/semihost_hardfault.o ./source/task.d ./source/task.o ./source/touch.d ./source/touch.o
+	-$(RM) ./source/config.d ./source/config.o ./source/filter.d ./source/filter.o ./source/i2c.d ./source/i2c.o ./source/led.d ./source/led.o ./source/lidar.d ./source/lidar.o ./source/log.d ./source/log.o ./source/main.d ./source/main.o ./source/memwatch.d ./source/memwatch.o ./source/mtb.d ./source/mtb.o ./source/perf.d ./source/perf.o ./source/pipeline.d ./source/pipeline.o ./source/power.d ./source/power.o ./source/replay.d ./source/replay.o ./source/runtime.d ./source/runtime.o ./source/semihost_hardfault.d ./source/semihost_hardfault.o ./source/task.d ./source/task.o ./source/touch.d ./source/touch.o ./source/trace.d ./source/trace.o ./source/ttc.d ./source/ttc.o ./source/zone.d ./source/zone.o
 
 .PHONY: clean-source
 
@@ -0,0 +1,104 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    fsl_lptmr.h
+ * @brief   Minimal LPTMR driver
+ *
+ * This header file provides the subset of the SDK LPTMR driver API used by
+ * the FreeRTOS tickless backend (freertos/fsl_tickless_lptmr.c). The project
+ * does not ship the full SDK driver; replace this file with it if more of
+ * the LPTMR is needed.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef _FSL_LPTMR_H_
+#define _FSL_LPTMR_H_
+
+#include "fsl_common.h"
+
+/*! @brief LPTMR status flags */
+typedef enum _lptmr_status_flags
+{
+    kLPTMR_TimerCompareFlag = LPTMR_CSR_TCF_MASK, /*!< Timer compare flag */
+} lptmr_status_flags_t;
+
+/*!
+ * @brief Clears the LPTMR status flags.
+ *
+ * @param base LPTMR peripheral base address
+ * @param mask The status flags to clear, a combination of lptmr_status_flags_t
+ */
+static inline void LPTMR_ClearStatusFlags(LPTMR_Type *base, uint32_t mask)
+{
+    base->CSR |= mask;
+}
+
+/*!
+ * @brief Sets the timer period in units of count.
+ *
+ * The compare flag is set once the counter reaches ticks - 1.
+ *
+ * @param base  LPTMR peripheral base address
+ * @param ticks Timer period in units of count, at least one
+ */
+static inline void LPTMR_SetTimerPeriod(LPTMR_Type *base, uint32_t ticks)
+{
+    assert(ticks > 0);
+    base->CMR = ticks - 1U;
+}
+
+/*!
+ * @brief Reads the current timer counting value.
+ *
+ * The counter must be written before each read to latch its value.
+ *
+ * @param base LPTMR peripheral base address
+ * @return The current counter value in ticks
+ */
+static inline uint32_t LPTMR_GetCurrentTimerCount(LPTMR_Type *base)
+{
+    base->CNR = 0;
+    return base->CNR;
+}
+
+/*!
+ * @brief Starts the timer; the counter starts from zero.
+ *
+ * @param base LPTMR peripheral base address
+ */
+static inline void LPTMR_StartTimer(LPTMR_Type *base)
+{
+    uint32_t reg = base->CSR;
+
+    /* Don't clear the TCF bit accidentally */
+    reg &= ~(LPTMR_CSR_TCF_MASK);
+    reg |= LPTMR_CSR_TEN_MASK;
+    base->CSR = reg;
+}
+
+/*!
+ * @brief Stops the timer, which also resets the counter.
+ *
+ * @param base LPTMR peripheral base address
+ */
+static inline void LPTMR_StopTimer(LPTMR_Type *base)
+{
+    uint32_t reg = base->CSR;
+
+    /* Don't clear the TCF bit accidentally */
+    reg &= ~(LPTMR_CSR_TCF_MASK);
+    reg &= ~LPTMR_CSR_TEN_MASK;
+    base->CSR = reg;
+}
+
+#endif /* _FSL_LPTMR_H_ */
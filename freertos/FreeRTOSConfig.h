@@ -83,7 +83,7 @@
  *----------------------------------------------------------*/
 
 #define configUSE_PREEMPTION                    1
-#define configUSE_TICKLESS_IDLE                 0
+#define configUSE_TICKLESS_IDLE                 1
 #define configCPU_CLOCK_HZ                      (SystemCoreClock)
 #define configTICK_RATE_HZ                      ((TickType_t)1000)
 #define configMAX_PRIORITIES                    5
@@ -104,24 +104,73 @@
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
 #define configUSE_APPLICATION_TASK_TAG          0
 
+/* Tickless idle: the LPTMR counts the 1 kHz LPO while the tick is suppressed,
+and source/power.c picks wait or stop mode. The tick is only suppressed in
+forward gear; see power_idle(). */
+#include <stdint.h>
+extern void power_idle(uint32_t idle);
+extern uint32_t power_pre_sleep(uint32_t idle);
+extern void power_post_sleep(uint32_t idle);
+#define portSUPPRESS_TICKS_AND_SLEEP(x)         power_idle(x)
+#define configLPTMR_CLOCK_HZ                    1000
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   2
+#define configPRE_SLEEP_PROCESSING(x)           (x) = power_pre_sleep(x)
+#define configPOST_SLEEP_PROCESSING(x)          power_post_sleep(x)
+
 /* Memory allocation related definitions. */
-#define configSUPPORT_STATIC_ALLOCATION         0
-#define configSUPPORT_DYNAMIC_ALLOCATION        1
+/* Every kernel object is allocated statically (see source/main.c), so heap_4 is
+not built (excluded in .cproject); set DYNAMIC to 1 and drop heap_4.c from the
+freertos exclusion list to use xTaskCreate. */
+#define configSUPPORT_STATIC_ALLOCATION         1
+#define configSUPPORT_DYNAMIC_ALLOCATION        0
 #define configTOTAL_HEAP_SIZE                   ((size_t)(10240))
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
 /* Hook function related definitions. */
 #define configUSE_IDLE_HOOK                     0
 #define configUSE_TICK_HOOK                     0
-#define configCHECK_FOR_STACK_OVERFLOW          0
-#define configUSE_MALLOC_FAILED_HOOK            0
+#define configCHECK_FOR_STACK_OVERFLOW          2
+#define configUSE_MALLOC_FAILED_HOOK            configSUPPORT_DYNAMIC_ALLOCATION
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
+/* Run-time stats clock: TPM1 extended to 32 bits, see source/runtime.c. */
+extern void runtime_init(void);
+extern uint32_t runtime_counter(void);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() runtime_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()         runtime_counter()
+
+/* Scheduler trace of the DEBUG build: compact records in a RAM ring, dumped as
+Chrome trace JSON, see source/trace.c. */
+#ifdef DEBUG
+#include "trace.h"
+#define traceTASK_SWITCHED_IN()                 trace_event(TRACE_SWITCH_IN, NULL, 0)
+#define traceTASK_SWITCHED_OUT()                trace_event(TRACE_SWITCH_OUT, NULL, 0)
+#define traceTASK_DELAY()                       trace_event(TRACE_DELAY, NULL, xTicksToDelay)
+#define traceTASK_DELAY_UNTIL(x)                trace_event(TRACE_DELAY_UNTIL, NULL, 0)
+#define traceTASK_SUSPEND(task)                 trace_event(TRACE_SUSPEND, (task), 0)
+#define traceTASK_RESUME(task)                  trace_event(TRACE_RESUME, (task), 0)
+#define traceTASK_RESUME_FROM_ISR(task)         trace_event(TRACE_RESUME_FROM_ISR, (task), 0)
+#define traceQUEUE_SEND(queue)                  trace_event(TRACE_QUEUE_SEND, (queue), 0)
+#define traceQUEUE_SEND_FROM_ISR(queue)         trace_event(TRACE_QUEUE_SEND_FROM_ISR, (queue), 0)
+#define traceQUEUE_RECEIVE(queue)               trace_event(TRACE_QUEUE_RECEIVE, (queue), 0)
+#define traceBLOCKING_ON_QUEUE_SEND(queue)      trace_event(TRACE_QUEUE_BLOCK_SEND, (queue), 0)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(queue)   trace_event(TRACE_QUEUE_BLOCK_RECEIVE, (queue), 0)
+#define traceTASK_NOTIFY()                      trace_event(TRACE_NOTIFY, pxTCB, 0)
+#define traceTASK_NOTIFY_FROM_ISR()             trace_event(TRACE_NOTIFY_FROM_ISR, pxTCB, 0)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR()        trace_event(TRACE_NOTIFY_FROM_ISR, pxTCB, 0)
+#define traceTASK_NOTIFY_TAKE()                 trace_event(TRACE_NOTIFY_TAKE, NULL, 0)
+#define traceTASK_NOTIFY_TAKE_BLOCK()           trace_event(TRACE_NOTIFY_TAKE_BLOCK, NULL, 0)
+#define traceTASK_NOTIFY_WAIT()                 trace_event(TRACE_NOTIFY_WAIT, NULL, 0)
+#define traceTASK_NOTIFY_WAIT_BLOCK()           trace_event(TRACE_NOTIFY_WAIT_BLOCK, NULL, 0)
+#define traceEVENT_GROUP_SET_BITS(group, bits)  trace_event(TRACE_EVENT_SET_BITS, NULL, (bits))
+#define traceEVENT_GROUP_WAIT_BITS_BLOCK(group, bits) trace_event(TRACE_EVENT_WAIT_BLOCK, NULL, (bits))
+#endif
+
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
 #define configMAX_CO_ROUTINE_PRIORITIES         2
@@ -145,8 +194,8 @@
 #define INCLUDE_vTaskDelay                      1
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
-#define INCLUDE_uxTaskGetStackHighWaterMark     0
-#define INCLUDE_xTaskGetIdleTaskHandle          0
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
 #define INCLUDE_eTaskGetState                   0
 #define INCLUDE_xEventGroupSetBitFromISR        1
 #define INCLUDE_xTimerPendFunctionCall          1
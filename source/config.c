@@ -0,0 +1,305 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    config.c
+ * @brief   Flash-persisted configuration store
+ *
+ * This source file implements the log-structured store declared in config.h.
+ *
+ * A sector starts with a header (sequence number, then magic) followed by
+ * 8-byte records (key and CRC16 in the first word, value in the second).
+ * Power-loss safety comes from the programming order:
+ * - a record's value is programmed before its key/CRC word, and a slot is
+ *   only reused once both words read erased, so a torn record is skipped;
+ * - when a sector fills, the live values are written to the freshly erased
+ *   other sector and its magic is programmed last, so until that moment the
+ *   old sector stays the one found at boot. With both headers valid, the
+ *   higher sequence number wins.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "config.h"
+#include "macros.h"
+
+#define CONFIG_ERASED (0xFFFFFFFFu) // Content of an erased flash word
+#define CONFIG_CRC_POLY (0x1021)    // CRC16-CCITT polynomial
+#define CONFIG_CRC_INIT (0xFFFF)
+
+/**
+ * @struct config_header_t
+ * @brief First eight bytes of a store sector.
+ */
+typedef struct {
+    uint32_t sequence; /**< Incremented on every compaction */
+    uint32_t magic;    /**< CONFIG_MAGIC once the sector holds a complete copy */
+} config_header_t;
+
+/**
+ * @struct config_record_t
+ * @brief One update of one key.
+ */
+typedef struct {
+    uint16_t key;   /**< A config_key_t */
+    uint16_t crc;   /**< CRC16 of key and value */
+    uint32_t value; /**< Stored value */
+} config_record_t;
+
+#define CONFIG_SLOTS ((CONFIG_SECTOR_SIZE - sizeof(config_header_t)) / sizeof(config_record_t))
+
+static flash_config_t flash; /**< Flash driver state. */
+static uint32_t cache[CONFIG_KEY_COUNT]; /**< Latest value of each key. */
+static uint8_t cached[CONFIG_KEY_COUNT]; /**< Set for the keys held in cache. */
+static uint8_t active; /**< Sector holding the current log. */
+static uint32_t sequence; /**< Sequence number of the active sector. */
+static uint16_t next_slot; /**< First free record slot of the active sector. */
+
+/**
+ * @brief Returns the header of a store sector.
+ */
+static const config_header_t *config_header(uint8_t sector) {
+    return (const config_header_t *)(CONFIG_BASE + (sector * CONFIG_SECTOR_SIZE));
+}
+
+/**
+ * @brief Returns the record slots of a store sector.
+ */
+static const config_record_t *config_records(uint8_t sector) {
+    return (const config_record_t *)(config_header(sector) + ONE);
+}
+
+/**
+ * @brief CRC16-CCITT of a record's key and value.
+ */
+static uint16_t config_crc(uint16_t key, uint32_t value) {
+    uint8_t bytes[] = { key, key >> EIGHT, value, value >> EIGHT,
+            value >> SIXTEEN, value >> TWENTY_FOUR };
+    uint16_t crc = CONFIG_CRC_INIT;
+    uint8_t i, bit;
+
+    for (i = ZERO; i < sizeof(bytes); i++) {
+        crc ^= (uint16_t)bytes[i] << EIGHT;
+        for (bit = ZERO; bit < EIGHT; bit++) {
+            crc = (crc & 0x8000) ? (crc << ONE) ^ CONFIG_CRC_POLY : crc << ONE;
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Programs one flash word with interrupts masked.
+ *
+ * The KL25Z has a single flash block, so nothing may be fetched from flash
+ * while the command runs; the driver runs the command loop from RAM.
+ */
+static status_t config_program(uint32_t address, uint32_t word) {
+    uint32_t masking_state = __get_PRIMASK();
+    status_t status;
+
+    __disable_irq();
+    status = FLASH_Program(&flash, address, &word, sizeof(word));
+    __set_PRIMASK(masking_state);
+    return status;
+}
+
+/**
+ * @brief Erases one store sector with interrupts masked.
+ */
+static status_t config_erase(uint8_t sector) {
+    uint32_t masking_state = __get_PRIMASK();
+    status_t status;
+
+    __disable_irq();
+    status = FLASH_Erase(&flash, (uint32_t)config_header(sector), CONFIG_SECTOR_SIZE,
+            kFLASH_ApiEraseKey);
+    __set_PRIMASK(masking_state);
+    return status;
+}
+
+/**
+ * @brief Appends one record to the active sector; the caller checks there is room.
+ */
+static status_t config_append(uint16_t key, uint32_t value) {
+    uint32_t address = (uint32_t)&config_records(active)[next_slot];
+    status_t status;
+
+    // A slot is used as soon as anything was programmed into it
+    next_slot++;
+
+    status = config_program(address + sizeof(uint32_t), value);
+    if (status == kStatus_Success) {
+        // The key/CRC word commits the record
+        status = config_program(address,
+                ((uint32_t)config_crc(key, value) << SIXTEEN) | key);
+    }
+    return status;
+}
+
+/**
+ * @brief Erases a sector and starts it with the given sequence number.
+ *
+ * The magic is programmed by the caller once the sector holds all values.
+ */
+static status_t config_format(uint8_t sector, uint32_t seq) {
+    status_t status = config_erase(sector);
+
+    if (status == kStatus_Success) {
+        status = config_program((uint32_t)&config_header(sector)->sequence, seq);
+    }
+    return status;
+}
+
+/**
+ * @brief Moves the live values to the other sector and makes it the active one.
+ */
+static status_t config_compact(void) {
+    uint8_t target = active ^ ONE;
+    status_t status;
+    uint8_t key;
+
+    status = config_format(target, sequence + ONE);
+    if (status != kStatus_Success) {
+        return status;
+    }
+
+    active = target;
+    sequence++;
+    next_slot = ZERO;
+    for (key = ZERO; key < CONFIG_KEY_COUNT; key++) {
+        if (cached[key]) {
+            status = config_append(key, cache[key]);
+            if (status != kStatus_Success) {
+                return status;
+            }
+        }
+    }
+
+    return config_program((uint32_t)&config_header(active)->magic, CONFIG_MAGIC);
+}
+
+/**
+ * @brief Replays the records of the active sector into the cache.
+ */
+static void config_replay(void) {
+    const config_record_t *records = config_records(active);
+    const uint32_t *words;
+    uint16_t slot;
+
+    next_slot = ZERO;
+    for (slot = ZERO; slot < CONFIG_SLOTS; slot++) {
+        words = (const uint32_t *)&records[slot];
+        if ((words[ZERO] == CONFIG_ERASED) && (words[ONE] == CONFIG_ERASED)) {
+            continue;
+        }
+        // Append after the last slot that was touched, torn or not
+        next_slot = slot + ONE;
+        if ((records[slot].key < CONFIG_KEY_COUNT)
+                && (records[slot].crc == config_crc(records[slot].key, records[slot].value))) {
+            cache[records[slot].key] = records[slot].value;
+            cached[records[slot].key] = ONE;
+        }
+    }
+}
+
+/**
+ * @brief Finds the active sector and loads its records into the RAM cache.
+ */
+status_t config_init(void) {
+    const config_header_t *header;
+    uint8_t found = ZERO;
+    uint8_t sector;
+    status_t status;
+
+    status = FLASH_Init(&flash);
+    if (status != kStatus_Success) {
+        return status;
+    }
+#if FLASH_DRIVER_IS_FLASH_RESIDENT
+    status = FLASH_PrepareExecuteInRamFunctions(&flash);
+    if (status != kStatus_Success) {
+        return status;
+    }
+#endif
+
+    // The complete sector with the most recent sequence number is the active one
+    for (sector = ZERO; sector < CONFIG_SECTORS; sector++) {
+        header = config_header(sector);
+        if ((header->magic == CONFIG_MAGIC)
+                && (!found || ((int32_t)(header->sequence - sequence) > ZERO))) {
+            found = ONE;
+            active = sector;
+            sequence = header->sequence;
+        }
+    }
+
+    if (!found) {
+        // Blank or never completed: start an empty store
+        active = ZERO;
+        sequence = ZERO;
+        status = config_format(active, sequence);
+        if (status == kStatus_Success) {
+            status = config_program((uint32_t)&config_header(active)->magic, CONFIG_MAGIC);
+        }
+        next_slot = ZERO;
+        return status;
+    }
+
+    config_replay();
+    return kStatus_Success;
+}
+
+/**
+ * @brief Reads a value from the RAM cache.
+ */
+uint32_t config_get(config_key_t key, uint32_t fallback) {
+    return ((key < CONFIG_KEY_COUNT) && cached[key]) ? cache[key] : fallback;
+}
+
+/**
+ * @brief Stores a value, appending a record to flash if it changed.
+ */
+status_t config_set(config_key_t key, uint32_t value) {
+    if (key >= CONFIG_KEY_COUNT) {
+        return kStatus_InvalidArgument;
+    }
+    if (cached[key] && (cache[key] == value)) {
+        return kStatus_Success;
+    }
+
+    cache[key] = value;
+    cached[key] = ONE;
+
+    // A full sector is compacted, which already writes the new value
+    if (next_slot >= CONFIG_SLOTS) {
+        return config_compact();
+    }
+    return config_append(key, value);
+}
+
+/**
+ * @brief Forgets a stored value, so config_get() returns its fallback again.
+ *
+ * A record cannot be taken back from flash, so the store is compacted without
+ * the key.
+ */
+status_t config_clear(config_key_t key) {
+    if (key >= CONFIG_KEY_COUNT) {
+        return kStatus_InvalidArgument;
+    }
+    if (!cached[key]) {
+        return kStatus_Success;
+    }
+
+    cached[key] = ZERO;
+    return config_compact();
+}
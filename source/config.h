@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    config.h
+ * @brief   Flash-persisted configuration store
+ *
+ * This header file declares a key/value store kept in the last two flash
+ * sectors. Each update appends a CRC-checked record to the active sector;
+ * when it fills, the live values are copied to the other sector, so erases
+ * alternate between the two. At boot the records are replayed once into a
+ * RAM cache and every later read is an array lookup.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <stdint.h>
+#include "fsl_flash.h"
+
+#define CONFIG_SECTOR_SIZE (FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE) // Erase unit, 1 KB
+#define CONFIG_SECTORS (2) // Sectors the store alternates between
+#define CONFIG_BASE (FSL_FEATURE_FLASH_PFLASH_BLOCK_SIZE - (CONFIG_SECTORS * CONFIG_SECTOR_SIZE)) // Kept out of PROGRAM_FLASH by the linker script
+#define CONFIG_MAGIC (0x31474643) // "CFG1": the sector header is complete
+
+/**
+ * @enum config_key_t
+ * @brief Values held by the store.
+ */
+typedef enum {
+    CONFIG_TOUCH_PRESS,   /**< Touch counts above baseline for a press */
+    CONFIG_TOUCH_RELEASE, /**< Touch counts above baseline to stay pressed */
+    CONFIG_I2C_DIVIDER,   /**< I2C1 frequency divider register (F) */
+    CONFIG_KEY_COUNT      /**< Number of keys */
+} config_key_t;
+
+/**
+ * @brief Finds the active sector and loads its records into the RAM cache.
+ *
+ * Must run before the scheduler starts and before any config_get().
+ *
+ * @return kStatus_Success, or the flash driver error if no sector could be formatted.
+ */
+status_t config_init(void);
+
+/**
+ * @brief Reads a value from the RAM cache.
+ *
+ * @param key Value to read.
+ * @param fallback Value returned if the key was never stored.
+ * @return The stored value, or fallback.
+ */
+uint32_t config_get(config_key_t key, uint32_t fallback);
+
+/**
+ * @brief Stores a value, appending a record to flash if it changed.
+ *
+ * Programming stalls the flash, so interrupts are masked while a record is
+ * written (tens of microseconds) or a sector erased (up to about 100 ms). Call
+ * it only in forward gear.
+ *
+ * @param key Value to write.
+ * @param value New value.
+ * @return kStatus_Success, or the flash driver error.
+ */
+status_t config_set(config_key_t key, uint32_t value);
+
+/**
+ * @brief Forgets a stored value, so config_get() returns its fallback again.
+ *
+ * The live values are compacted into the other sector, which erases it; call
+ * it only in forward gear, like config_set().
+ *
+ * @param key Value to forget.
+ * @return kStatus_Success, or the flash driver error.
+ */
+status_t config_clear(config_key_t key);
+
+#endif /* CONFIG_H_ */
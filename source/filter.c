@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    filter.c
+ * @brief   Fixed-point distance filter
+ *
+ * This source file contains the stages of the distance filter and the chain
+ * running them. Distances are carried as q15_t, one count per centimetre,
+ * which covers the TF-Luna range with room to spare.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "filter.h"
+#include "macros.h"
+
+static q15_t filter_median(distance_filter_t *filter, q15_t distance);
+static q15_t filter_ema(distance_filter_t *filter, q15_t distance);
+
+/**
+ * @brief Stages run on every distance, in order. Remove or reorder entries to
+ *        change the chain.
+ */
+static const filter_stage_t filter_stages[] = { filter_median, filter_ema };
+
+/**
+ * @brief Forgets all samples, so the next distance passes through unchanged.
+ */
+void filter_reset(distance_filter_t *filter) {
+    filter->index = ZERO;
+    filter->count = ZERO;
+    filter->primed = ZERO;
+    filter->ema = ZERO;
+}
+
+/**
+ * @brief Returns the median of the last FILTER_MEDIAN_WINDOW distances.
+ *
+ * The window is short, so an insertion sort of a copy is cheaper than keeping
+ * it sorted. Until the window fills, the median of the samples seen so far is
+ * returned.
+ */
+static q15_t filter_median(distance_filter_t *filter, q15_t distance) {
+    q15_t sorted[FILTER_MEDIAN_WINDOW];
+    q15_t value;
+    uint8_t i, j;
+
+    filter->window[filter->index] = distance;
+    filter->index = (filter->index + ONE) % FILTER_MEDIAN_WINDOW;
+    if (filter->count < FILTER_MEDIAN_WINDOW) {
+        filter->count++;
+    }
+
+    for (i = ZERO; i < filter->count; i++) {
+        value = filter->window[i];
+        for (j = i; j && (sorted[j - ONE] > value); j--) {
+            sorted[j] = sorted[j - ONE];
+        }
+        sorted[j] = value;
+    }
+
+    return sorted[filter->count / TWO];
+}
+
+/**
+ * @brief First-order IIR low pass: ema += alpha * (distance - ema), in q15.
+ *
+ * The state keeps 16 fractional bits below the centimetre, so small steps are
+ * not lost to truncation. The first sample after a reset seeds the state.
+ */
+static q15_t filter_ema(distance_filter_t *filter, q15_t distance) {
+    q31_t target = (q31_t)distance << SIXTEEN;
+
+    if (!filter->primed) {
+        filter->primed = ONE;
+        filter->ema = target;
+    } else {
+        filter->ema += (q31_t)(((q63_t)(target - filter->ema) * FILTER_EMA_ALPHA_Q15) >> 15);
+    }
+
+    // Round to the nearest centimetre
+    return (q15_t)((filter->ema + (ONE << (SIXTEEN - ONE))) >> SIXTEEN);
+}
+
+/**
+ * @brief Runs a raw distance through every stage of the filter chain.
+ */
+uint16_t filter_apply(distance_filter_t *filter, uint16_t distance) {
+    q15_t value = clip_q31_to_q15((q31_t)distance);
+    uint8_t i;
+
+    for (i = ZERO; i < (sizeof(filter_stages) / sizeof(filter_stages[0])); i++) {
+        value = filter_stages[i](filter, value);
+    }
+
+    return (uint16_t)value;
+}
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    filter.h
+ * @brief   Fixed-point distance filter
+ *
+ * This header file declares the filter stage run on every LiDAR distance
+ * between acquisition and zone classification: a median over the last
+ * FILTER_MEDIAN_WINDOW frames rejects single-frame outliers, then a q15
+ * exponential moving average smooths the remaining noise. No floating point
+ * is used, as the Cortex-M0+ has no FPU.
+ *
+ * Step response: the median delays a step by (FILTER_MEDIAN_WINDOW - 1) / 2
+ * samples; the EMA then reaches 90 % of the step after about
+ * ln(0.1) / ln(1 - alpha) samples. With the defaults (window 5, alpha 0.5)
+ * that is 2 + 4 samples, 60 ms at 100 Hz.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include <stdint.h>
+
+#ifndef ARM_MATH_CM0PLUS
+#define ARM_MATH_CM0PLUS
+#endif
+#include "arm_math.h"
+
+#define FILTER_MEDIAN_WINDOW (5)     // Frames in the median window; odd, 1 disables it
+#define FILTER_MEDIAN_MAX    (9)     // Largest window the insertion sort is meant for
+#define FILTER_EMA_ALPHA_Q15 (16384) // EMA weight of a new sample in q15 (0.5)
+
+#if !(FILTER_MEDIAN_WINDOW & 1) || (FILTER_MEDIAN_WINDOW > FILTER_MEDIAN_MAX)
+#error "FILTER_MEDIAN_WINDOW must be odd and at most FILTER_MEDIAN_MAX"
+#endif
+#if (FILTER_EMA_ALPHA_Q15 <= 0) || (FILTER_EMA_ALPHA_Q15 > 32767)
+#error "FILTER_EMA_ALPHA_Q15 must lie in (0, 1) in q15"
+#endif
+
+/**
+ * @struct distance_filter_t
+ * @brief State of the distance filter of one LiDAR.
+ */
+typedef struct {
+    q15_t window[FILTER_MEDIAN_WINDOW]; /**< Latest distances, oldest overwritten first */
+    uint8_t index;                      /**< Slot of window to overwrite next */
+    uint8_t count;                      /**< Valid entries in window */
+    uint8_t primed;                     /**< Set once the EMA holds a sample */
+    q31_t ema;                          /**< EMA output, q15 distance shifted to q31 */
+} distance_filter_t;
+
+/**
+ * @brief One stage of the filter chain.
+ *
+ * @param filter Filter state.
+ * @param distance Output of the previous stage, in centimetres.
+ * @return Filtered distance in centimetres.
+ */
+typedef q15_t (*filter_stage_t)(distance_filter_t *filter, q15_t distance);
+
+/**
+ * @brief Forgets all samples, so the next distance passes through unchanged.
+ *
+ * @param filter Filter state.
+ */
+void filter_reset(distance_filter_t *filter);
+
+/**
+ * @brief Runs a raw distance through every stage of the filter chain.
+ *
+ * @param filter Filter state.
+ * @param distance Raw distance in centimetres.
+ * @return Filtered distance in centimetres.
+ */
+uint16_t filter_apply(distance_filter_t *filter, uint16_t distance);
+
+#endif /* FILTER_H_ */
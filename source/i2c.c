@@ -15,9 +15,49 @@
  */
 
 #include <MKL25Z4.H>
+#include "FreeRTOS.h"
+#include "task.h"
 #include "i2c.h"
-int lock_detect=0;
-int i2c_lock=0;
+#include "config.h"
+#include "macros.h"
+#include "runtime.h"
+#include "perf.h"
+#include <string.h>
+
+static i2c_stats_t i2c_stats;
+
+/* Retry policy applied by i2c_read() and i2c_write() */
+static i2c_policy_t i2c_policy = { I2C_ATTEMPTS, I2C_BACKOFF_MS };
+
+/**
+ * @enum i2c_state_t
+ * @brief States of the interrupt-driven transfer engine.
+ */
+typedef enum {
+    I2C_STATE_IDLE,       /**< No transfer in progress */
+    I2C_STATE_DEV_ADDR,   /**< Device address (write) on the bus */
+    I2C_STATE_REG_ADDR,   /**< Register address on the bus */
+    I2C_STATE_WRITE_DATA, /**< Data bytes being written */
+    I2C_STATE_READ_ADDR,  /**< Device address (read) after repeated start */
+    I2C_STATE_READ_DATA   /**< Data bytes being received */
+} i2c_state_t;
+
+/**
+ * @struct i2c_transfer_t
+ * @brief Transfer descriptor shared between the calling task and the ISR.
+ */
+typedef struct {
+    volatile i2c_state_t state; /**< Current engine state */
+    uint8_t dev;                /**< Device address (7-bit, pre-shifted) */
+    uint8_t reg;                /**< Register address */
+    uint8_t *buf;               /**< Data buffer */
+    uint8_t len;                /**< Number of bytes to transfer */
+    uint8_t index;              /**< Bytes transferred so far */
+    uint8_t is_read;            /**< Non-zero for a register read */
+    TaskHandle_t waiter;        /**< Task notified on completion */
+} i2c_transfer_t;
+
+static i2c_transfer_t xfer = { I2C_STATE_IDLE };
 
 /**
  * @brief Initializes the I2C1 module.
@@ -39,288 +79,630 @@ void i2c_init(void) {
     PORTE->PCR[0] |= PORT_PCR_MUX(6); // SDA
     PORTE->PCR[1] |= PORT_PCR_MUX(6); // SCL
 
-    // Set the I2C1 frequency divider and multiplier for buad of 400k
-    I2C1->F = (I2C_F_ICR(0x11) | I2C_F_MULT(0));
+    // Set the I2C1 frequency divider and multiplier for buad of 400k, unless
+    // another divider was stored for this unit
+    I2C1->F = config_get(CONFIG_I2C_DIVIDER, I2C_F_ICR(0x11) | I2C_F_MULT(0));
 
     // Enable the I2C1 module
     I2C1->C1 |= (I2C_C1_IICEN_MASK);
 
     // Enable High Drive Select
     I2C1->C2 |= (I2C_C2_HDRS_MASK);
+
+    // Route I2C1 interrupts to the NVIC; IICIE itself is only set per transfer
+    NVIC_SetPriority(I2C1_IRQn, I2C_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(I2C1_IRQn);
+    NVIC_EnableIRQ(I2C1_IRQn);
 }
 
 /**
- * @brief Handles scenarios where the I2C bus is busy or locked.
+ * @brief Busy-waits for roughly the given number of microseconds.
  *
- * This function attempts to unlock the I2C bus and clear any potential bus lock.
- * It uses arbitration and transmission to reset the bus and then re-enables I2C.
- * Additionally, it sets flags for bus lock detection.
+ * Used for the bit-banged recovery clock, which has to run whether or not the
+ * scheduler (and with it SysTick) is up.
  *
- * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
- *        ARM Cortex-M based Microcontrollers", chapter 8.
+ * @param us Delay in microseconds.
  */
-void i2c_busy(void) {
-    // Variables for bus lock detection
-    lock_detect = 0;
-    i2c_lock = 1;
+static void i2c_delay_us(uint32_t us) {
+    volatile uint32_t spins = us * (SystemCoreClock / (THOUSAND * THOUSAND))
+            / I2C_SPIN_CYCLES;
 
-    // Disable I2C and configure for transmission
-    I2C1->C1 &= ~I2C_C1_IICEN_MASK;
-    I2C_TRAN;
-    I2C_M_START;
-    I2C1->C1 |= I2C_C1_IICEN_MASK;
-    I2C1->C1 |= I2C_C1_MST_MASK;
-    I2C1->C1 |= I2C_C1_TX_MASK;
-    I2C1->D = 0xFF;
-
-    // Wait for completion of the operation
-    while ((I2C1->S & I2C_S_IICIF_MASK) == 0U) {
+    while (spins) {
+        spins--;
     }
+}
 
-    // Clear the interrupt flag
-    I2C1->S |= I2C_S_IICIF_MASK;
+/**
+ * @brief Releases a bit-banged line and lets the pull-up take it high.
+ *
+ * @param pin PTE pin number (I2C_SDA_PIN or I2C_SCL_PIN).
+ */
+static inline void i2c_line_release(uint32_t pin) {
+    PTE->PDDR &= ~(ONE << pin);
+}
 
-    // Set the arbitration lost flag
-    I2C1->S |= I2C_S_ARBL_MASK;
+/**
+ * @brief Drives a bit-banged line low.
+ *
+ * @param pin PTE pin number (I2C_SDA_PIN or I2C_SCL_PIN).
+ */
+static inline void i2c_line_low(uint32_t pin) {
+    PTE->PCOR = (ONE << pin);
+    PTE->PDDR |= (ONE << pin);
+}
 
-    // Disable I2C, set for transmission, and set master mode
-    I2C1->C1 &= ~I2C_C1_IICEN_MASK;
-    I2C1->C1 |= I2C_C1_TX_MASK;
-    I2C1->C1 |= I2C_C1_MST_MASK;
-    I2C1->C1 |= I2C_C1_IICEN_MASK;
+/**
+ * @brief Reads the level of a bit-banged line.
+ *
+ * @param pin PTE pin number (I2C_SDA_PIN or I2C_SCL_PIN).
+ *
+ * @return Non-zero if the line is high.
+ */
+static inline uint32_t i2c_line_high(uint32_t pin) {
+    return PTE->PDIR & (ONE << pin);
+}
 
-    // Disable I2C, set master mode, clear master mode, clear transmission mode, and enable I2C
-    I2C1->C1 &= ~I2C_C1_IICEN_MASK;
-    I2C1->C1 |= I2C_C1_MST_MASK;
-    I2C1->C1 &= ~I2C_C1_MST_MASK;
-    I2C1->C1 &= ~I2C_C1_TX_MASK;
-    I2C1->C1 |= I2C_C1_IICEN_MASK;
+/**
+ * @brief Frees a bus held by a slave and resets the I2C1 module.
+ *
+ * A slave reset in the middle of a read keeps driving SDA low while it waits
+ * for the rest of its byte, and the I2C1 module cannot generate a STOP on a
+ * bus it does not own. PTE0/PTE1 are switched to GPIO, SCL is clocked up to
+ * I2C_RECOVERY_CLOCKS times until the slave lets go of SDA, a STOP is driven
+ * by hand and the pins are handed back to I2C1. Every step is bounded, so a
+ * slave that never releases the bus, or stretches every clock to the limit,
+ * costs at most I2C_RECOVERY_MAX_US (about 0.5 ms) rather than the task.
+ *
+ * @return 1 if SDA is high again, 0 if the bus is still stuck.
+ */
+uint8_t i2c_recover(void) {
+    uint32_t sda_pcr = PORTE->PCR[I2C_SDA_PIN];
+    uint32_t scl_pcr = PORTE->PCR[I2C_SCL_PIN];
+    uint32_t stretch;
+    uint8_t released;
+
+    // Take the pins away from the module; it is reset on the way back
+    I2C1->C1 &= ~(I2C_C1_IICEN_MASK | I2C_C1_IICIE_MASK);
+
+    // Open-drain emulation: outputs latch low, PDDR decides driven or released
+    SIM->SCGC5 |= SIM_SCGC5_PORTE_MASK;
+    PTE->PDDR &= ~((ONE << I2C_SDA_PIN) | (ONE << I2C_SCL_PIN));
+    PORTE->PCR[I2C_SDA_PIN] = PORT_PCR_MUX(1) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
+    PORTE->PCR[I2C_SCL_PIN] = PORT_PCR_MUX(1) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
+    i2c_delay_us(I2C_RECOVERY_HALF_US);
+
+    // Clock out whatever byte the slave thinks it is still sending
+    for (uint32_t i = 0; (i < I2C_RECOVERY_CLOCKS) && !i2c_line_high(I2C_SDA_PIN); i++) {
+        i2c_line_low(I2C_SCL_PIN);
+        i2c_delay_us(I2C_RECOVERY_HALF_US);
+        i2c_line_release(I2C_SCL_PIN);
+        // Honour clock stretching, but not forever
+        for (stretch = 0; !i2c_line_high(I2C_SCL_PIN) && (stretch < I2C_RECOVERY_CLOCKS);
+                stretch++) {
+            i2c_delay_us(I2C_RECOVERY_HALF_US);
+        }
+        i2c_delay_us(I2C_RECOVERY_HALF_US);
+    }
 
-    // Set the interrupt flag and arbitration lost flag
-    I2C1->S |= I2C_S_IICIF_MASK;
-    I2C1->S |= I2C_S_ARBL_MASK;
+    // STOP: SDA rises while SCL is high
+    i2c_line_low(I2C_SCL_PIN);
+    i2c_delay_us(I2C_RECOVERY_HALF_US);
+    i2c_line_low(I2C_SDA_PIN);
+    i2c_delay_us(I2C_RECOVERY_HALF_US);
+    i2c_line_release(I2C_SCL_PIN);
+    i2c_delay_us(I2C_RECOVERY_HALF_US);
+    i2c_line_release(I2C_SDA_PIN);
+    i2c_delay_us(I2C_RECOVERY_HALF_US);
+
+    released = (i2c_line_high(I2C_SDA_PIN) && i2c_line_high(I2C_SCL_PIN)) ? ONE : ZERO;
+
+    // Hand the pins back to I2C1 and restart the module as an idle slave
+    PORTE->PCR[I2C_SDA_PIN] = sda_pcr;
+    PORTE->PCR[I2C_SCL_PIN] = scl_pcr;
+    I2C1->C1 = ZERO;
+    I2C1->S = I2C_S_IICIF_MASK | I2C_S_ARBL_MASK;
+    I2C1->C1 = I2C_C1_IICEN_MASK;
+
+    i2c_stats.recoveries++;
+    if (!released) {
+        i2c_stats.stuck++;
+    }
 
-    // Reset variables
-    lock_detect = 0;
-    i2c_lock = 1;
+    return released;
 }
 
-
 /**
  * @brief Waits for the I2C interrupt flag and handles bus lock scenarios.
  *
  * This function waits for the I2C interrupt flag to be set, indicating the completion
- * of the I2C operation. It also monitors for bus lock conditions, and if detected, invokes
- * the i2c_busy() function to reset the bus. The function clears the interrupt flag after use.
+ * of the I2C operation. The wait is bounded by I2C_BYTE_TIMEOUT_US; if the byte
+ * does not complete by then the bus is assumed locked and i2c_recover() frees it.
+ * Otherwise the flag is cleared and the byte is checked for lost arbitration
+ * and, when transmitting, for the slave acknowledge.
+ *
+ * @return I2C_OK, I2C_NACK, I2C_ARB_LOST or I2C_TIMEOUT.
  *
  * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
  *        ARM Cortex-M based Microcontrollers", chapter 8.
  */
-void i2c_wait(void) {
-    // Reset bus lock detection counter
-    lock_detect = 0;
-
-    // Wait for the I2C interrupt flag or bus lock conditions
-    while (((I2C1->S & I2C_S_IICIF_MASK) == 0) && (lock_detect < 200)) {
-        lock_detect++;
+i2c_status_t i2c_wait(void) {
+    uint32_t deadline = I2C_BYTE_TIMEOUT_US * (SystemCoreClock / (THOUSAND * THOUSAND))
+            / I2C_SPIN_CYCLES;
+    uint32_t spins = 0;
+    uint8_t status;
+
+    // Wait for the I2C interrupt flag or the deadline
+    while (((I2C1->S & I2C_S_IICIF_MASK) == 0) && (spins < deadline)) {
+        spins++;
     }
 
-    // If bus lock conditions are detected, invoke i2c_busy() to reset the bus
-    if (lock_detect >= 200) {
-        i2c_busy();
+    // If the byte never completed, reset the bus
+    if (spins >= deadline) {
+        i2c_stats.timeouts++;
+        (void)i2c_recover();
+        return I2C_TIMEOUT;
     }
 
     // Clear the I2C interrupt flag
-    I2C1->S |= I2C_S_IICIF_MASK;
-}
-
+    status = I2C1->S;
+    I2C1->S = I2C_S_IICIF_MASK;
+
+    // Another master took the bus; the module has already dropped to slave mode
+    if (status & I2C_S_ARBL_MASK) {
+        I2C1->S = I2C_S_ARBL_MASK;
+        i2c_stats.arbitration_lost++;
+        return I2C_ARB_LOST;
+    }
 
-/**
- * @brief Generates a start condition for I2C communication.
- *
- * This function sets the I2C module to transmit mode and generates a start condition
- * to initiate an I2C communication sequence.
- *
- * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
- *        ARM Cortex-M based Microcontrollers", chapter 8.
- */
-void i2c_start(void) {
-    // Set I2C to transmit mode
-    I2C_TRAN;
+    // Every transmitted byte must be acknowledged by the slave
+    if ((I2C1->C1 & I2C_C1_TX_MASK) && (status & I2C_S_RXAK_MASK)) {
+        i2c_stats.nacks++;
+        return I2C_NACK;
+    }
 
-    // Generate a start condition
-    I2C_M_START;
+    return I2C_OK;
 }
 
+
 /**
- * @brief Sets up the I2C module for reading data from a specific device and address.
+ * @brief Runs one register transfer by polling.
+ *
+ * Spins on IICIF between bytes and checks every byte through i2c_wait(); the
+ * first failure ends the transaction with a stop condition. It is only used
+ * before the scheduler is running.
  *
- * This function configures the I2C module to initiate a read operation from the specified
- * device and address. It sends the device address, the register address to read from, and
- * then restarts the communication to switch to reading mode.
+ * @param dev The I2C device address (7-bit, pre-shifted) to communicate with.
+ * @param address The register address to start at.
+ * @param buf Buffer holding the data to write or receiving the data read.
+ * @param len Number of data bytes, at least 1.
+ * @param is_read Non-zero for a read, zero for a write.
  *
- * @param dev The device address.
- * @param address The register address to read from.
+ * @return I2C_OK or the first error seen on the bus.
  *
  * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
  *        ARM Cortex-M based Microcontrollers", chapter 8.
  */
-void i2c_read_setup(uint8_t dev, uint8_t address) {
-    // Send device address
+static i2c_status_t i2c_poll_transfer(uint8_t dev, uint8_t address, uint8_t *buf,
+        uint8_t len, uint8_t is_read) {
+    i2c_status_t status;
+    uint8_t i;
+
+    // Start condition, device address (write) and register address
+    I2C_TRAN;
+    I2C_M_START;
     I2C1->D = dev;
-    I2C_WAIT;
+    status = i2c_wait();
+    if (status == I2C_OK) {
+        I2C1->D = address;
+        status = i2c_wait();
+    }
 
-    // Send register address
-    I2C1->D = address;
-    I2C_WAIT;
+    if (!is_read) {
+        for (i = 0; (i < len) && (status == I2C_OK); i++) {
+            I2C1->D = buf[i];
+            status = i2c_wait();
+        }
+        I2C_M_STOP;
+        return status;
+    }
 
-    // Restart and switch to reading mode
-    I2C_M_RSTART;
-    I2C1->D = (dev | 0x01);
-    I2C_WAIT;
+    // Repeated start for reading from the register address
+    if (status == I2C_OK) {
+        I2C_M_RSTART;
+        I2C1->D = (dev | 0x01);
+        status = i2c_wait();
+    }
+    if (status != I2C_OK) {
+        I2C_M_STOP;
+        return status;
+    }
 
-    // Set I2C to receive mode
+    // Switch to receive, NACK straight away if only one byte is wanted
     I2C_REC;
+    if (len == 1) {
+        NACK;
+    } else {
+        ACK;
+    }
+
+    // Dummy read clocks in the first data byte
+    (void)I2C1->D;
+    for (i = 0; i < len; i++) {
+        status = i2c_wait();
+        if (status != I2C_OK) {
+            I2C_M_STOP;
+            break;
+        }
+        if (i == (len - 1)) {
+            // Stop before reading D so no further byte is clocked in
+            I2C_M_STOP;
+        } else if (i == (len - 2)) {
+            // The byte clocked in next is the last one
+            NACK;
+        }
+        buf[i] = I2C1->D;
+    }
+    ACK;
+
+    return status;
 }
 
 /**
- * @brief Performs a repeated I2C read operation.
- *
- * This function reads data from the I2C bus and optionally sends
- * an acknowledgment or not based on the isLastRead parameter.
+ * @brief Ends the current interrupt-driven transfer and wakes the waiting task.
  *
- * @param isLastRead Indicates whether this is the last read in the sequence.
- *                   If true, a NACK (Not Acknowledge) is sent after the read.
- *                   If false, an ACK (Acknowledge) is sent after the read.
- *
- * @return The data read from the I2C bus.
+ * @param result Status of the transfer, delivered as the notification value.
+ * @param woken Set to pdTRUE if the notified task should run on ISR exit.
+ */
+static void i2c_finish(i2c_status_t result, BaseType_t *woken) {
+    // Stop raising interrupts until the next transfer is started
+    I2C1->C1 &= ~I2C_C1_IICIE_MASK;
+    xfer.state = I2C_STATE_IDLE;
+
+    xTaskNotifyFromISR(xfer.waiter, result, eSetValueWithOverwrite, woken);
+}
+
+/**
+ * @brief I2C1 interrupt handler driving the transfer state machine.
  *
- * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
- *        ARM Cortex-M based Microcontrollers", chapter 8.
+ * Each IICIF interrupt marks the end of one byte on the bus. The handler checks
+ * the slave acknowledge, loads the next byte (or issues the repeated start /
+ * stop) and notifies the waiting task once the transfer has finished, so the
+ * task sleeps for the whole transaction instead of spinning on IICIF.
  */
-uint8_t i2c_repeated_read(uint8_t isLastRead) {
-    uint8_t data;
+void I2C1_IRQHandler(void) {
+    BaseType_t woken = pdFALSE;
+    uint8_t status = I2C1->S;
 
-    // Reset the lock_detect flag.
-    lock_detect = 0;
+    // Acknowledge the byte-complete interrupt
+    I2C1->S = I2C_S_IICIF_MASK;
 
-    // Set the I2C acknowledgement based on whether this is the last read.
-    if (isLastRead) {
-        NACK;  // Set NACK if it's the last read.
-    } else {
-        ACK;   // Set ACK if it's not the last read.
+    if (xfer.state == I2C_STATE_IDLE) {
+        return;
     }
 
-    // Read data from the I2C data register.
-    data = I2C1->D;
-
-    // Wait for the I2C operation to complete.
-    I2C_WAIT
+    // Another master took the bus; the module has already dropped to slave mode
+    if (status & I2C_S_ARBL_MASK) {
+        I2C1->S = I2C_S_ARBL_MASK;
+        i2c_stats.arbitration_lost++;
+        i2c_finish(I2C_ARB_LOST, &woken);
+        portYIELD_FROM_ISR(woken);
+        return;
+    }
 
-    // If it's the last read, send a stop condition to end the I2C communication.
-    if (isLastRead) {
+    // Every transmitted byte must be acknowledged by the slave
+    if ((xfer.state != I2C_STATE_READ_DATA) && (status & I2C_S_RXAK_MASK)) {
         I2C_M_STOP;
+        i2c_stats.nacks++;
+        i2c_finish(I2C_NACK, &woken);
+        portYIELD_FROM_ISR(woken);
+        return;
     }
 
-    // Read data from the I2C data register.
-    data = I2C1->D;
+    switch (xfer.state) {
+    case I2C_STATE_DEV_ADDR:
+        // Device acknowledged, send the register address
+        I2C1->D = xfer.reg;
+        xfer.state = I2C_STATE_REG_ADDR;
+        break;
+
+    case I2C_STATE_REG_ADDR:
+        if (xfer.is_read) {
+            // Repeated start and switch the slave to transmit
+            I2C_M_RSTART;
+            I2C1->D = (xfer.dev | 0x01);
+            xfer.state = I2C_STATE_READ_ADDR;
+        } else {
+            I2C1->D = xfer.buf[0];
+            xfer.state = I2C_STATE_WRITE_DATA;
+        }
+        break;
+
+    case I2C_STATE_WRITE_DATA:
+        xfer.index++;
+        if (xfer.index < xfer.len) {
+            I2C1->D = xfer.buf[xfer.index];
+        } else {
+            I2C_M_STOP;
+            i2c_finish(I2C_OK, &woken);
+        }
+        break;
+
+    case I2C_STATE_READ_ADDR:
+        // Switch to receive, NACK straight away if only one byte is wanted
+        I2C_REC;
+        if (xfer.len == 1) {
+            NACK;
+        } else {
+            ACK;
+        }
+        // Dummy read clocks in the first data byte
+        (void)I2C1->D;
+        xfer.state = I2C_STATE_READ_DATA;
+        break;
+
+    case I2C_STATE_READ_DATA:
+        if (xfer.index == (xfer.len - 1)) {
+            // Stop before reading D so no further byte is clocked in
+            I2C_M_STOP;
+        } else if (xfer.index == (xfer.len - 2)) {
+            // The byte clocked in next is the last one
+            NACK;
+        }
+        xfer.buf[xfer.index++] = I2C1->D;
+        if (xfer.index == xfer.len) {
+            i2c_finish(I2C_OK, &woken);
+        }
+        break;
+
+    default:
+        break;
+    }
 
-    // Return the data read from the I2C bus.
-    return data;
+    portYIELD_FROM_ISR(woken);
 }
 
 /**
- * @brief Reads a byte from a specific address of an I2C device.
+ * @brief Runs one register transfer through the interrupt-driven engine.
  *
- * This function performs a complete I2C transaction to read a byte from a
- * specified address of the given I2C device.
+ * The calling task generates the start condition and the first address byte,
+ * then blocks on its task notification until the ISR reports completion. A
+ * transfer that does not finish within I2C_TIMEOUT_MS is abandoned and the bus
+ * is reset through i2c_recover().
  *
  * @param dev The I2C device address (7-bit) to communicate with.
- * @param address The register address from which to read the byte.
+ * @param address The register address to start at.
+ * @param buf Buffer holding the data to write or receiving the data read.
+ * @param len Number of data bytes.
+ * @param is_read Non-zero for a read, zero for a write.
  *
- * @return The data byte read from the specified address of the I2C device.
+ * @return I2C_OK or the error that ended the transfer.
+ */
+static i2c_status_t i2c_transfer(uint8_t dev, uint8_t address, uint8_t *buf,
+        uint8_t len, uint8_t is_read) {
+    uint32_t result = I2C_TIMEOUT;
+
+    // Describe the transfer for the ISR
+    xfer.dev = dev;
+    xfer.reg = address;
+    xfer.buf = buf;
+    xfer.len = len;
+    xfer.index = 0;
+    xfer.is_read = is_read;
+    xfer.waiter = xTaskGetCurrentTaskHandle();
+    xTaskNotifyStateClear(NULL);
+    xfer.state = I2C_STATE_DEV_ADDR;
+
+    // Clear any stale flag and enable the byte-complete interrupt
+    I2C1->S = I2C_S_IICIF_MASK;
+    I2C1->C1 |= I2C_C1_IICIE_MASK;
+
+    // Start condition and device address; the ISR takes it from here
+    I2C_TRAN;
+    I2C_M_START;
+    I2C1->D = dev;
+
+    // Sleep until the ISR reports the end of the transfer
+    if (xTaskNotifyWait(0, UINT32_MAX, &result,
+            pdMS_TO_TICKS(I2C_TIMEOUT_MS)) != pdTRUE) {
+        I2C1->C1 &= ~I2C_C1_IICIE_MASK;
+        xfer.state = I2C_STATE_IDLE;
+        i2c_stats.timeouts++;
+        (void)i2c_recover();
+        result = I2C_TIMEOUT;
+    }
+
+    return (i2c_status_t)result;
+}
+
+/**
+ * @brief Adds one transaction to the latency histogram.
  *
- * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
- *        ARM Cortex-M based Microcontrollers", chapter 8.
+ * @param counts Duration of the transaction in run-time clock counts.
  */
-uint8_t i2c_read_byte(uint8_t dev, uint8_t address) {
-    uint8_t data;
+static void i2c_record_latency(uint32_t counts) {
+    uint32_t us = (counts << RUNTIME_PRESCALE_SHIFT) / (configCPU_CLOCK_HZ / (THOUSAND * THOUSAND));
+    uint32_t bucket = 0;
 
-    // Set I2C to transmit mode.
-    I2C_TRAN;
+    while ((bucket < (I2C_LATENCY_BUCKETS - 1)) && (us >= (I2C_LATENCY_BASE_US << bucket))) {
+        bucket++;
+    }
 
-    // Start the I2C communication.
-    I2C_M_START;
+    i2c_stats.latency[bucket]++;
+}
 
-    // Send the I2C device address for writing.
-    I2C1->D = dev;
-    I2C_WAIT
+/**
+ * @brief Runs a register transfer under the retry policy.
+ *
+ * Before the scheduler is running the polled engine is used and the backoff is
+ * a busy wait; afterwards the transfer is interrupt driven, the task sleeps
+ * through the backoff and the whole transaction, retries included, is added to
+ * the latency histogram.
+ *
+ * @param dev The I2C device address (7-bit) to communicate with.
+ * @param address The register address to start at.
+ * @param buf Buffer holding the data to write or receiving the data read.
+ * @param len Number of data bytes.
+ * @param is_read Non-zero for a read, zero for a write.
+ *
+ * @return I2C_OK or the error of the last attempt.
+ */
+static i2c_status_t i2c_transact(uint8_t dev, uint8_t address, uint8_t *buf,
+        uint8_t len, uint8_t is_read) {
+    uint8_t running = (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+    uint32_t start = running ? runtime_counter() : 0;
+    uint32_t backoff = i2c_policy.backoff_ms;
+    i2c_status_t status = I2C_OK;
+
+    if (len == 0) {
+        return I2C_OK;
+    }
 
-    // Send the register address to read from.
-    I2C1->D =  address;
-    I2C_WAIT
+    for (uint8_t attempt = 0; attempt < i2c_policy.attempts; attempt++) {
+        if (attempt) {
+            // Give the slave time to finish whatever made it refuse, doubling each time
+            i2c_stats.retries++;
+            if (running) {
+                vTaskDelay(pdMS_TO_TICKS(backoff));
+            } else {
+                i2c_delay_us(backoff * THOUSAND);
+            }
+            backoff <<= ONE;
+        }
+
+        if (running) {
+            status = i2c_transfer(dev, address, buf, len, is_read);
+        } else {
+            status = i2c_poll_transfer(dev, address, buf, len, is_read);
+        }
+        if (status == I2C_OK) {
+            break;
+        }
+    }
 
-    // Repeated start for reading from the specified address.
-    I2C_M_RSTART;
+    if (running) {
+        i2c_record_latency(runtime_counter() - start);
+    }
 
-    // Send the I2C device address for reading.
-    I2C1->D = (dev | 0x01);
-    I2C_WAIT
+    return status;
+}
 
-    // Set I2C to receive mode.
-    I2C_REC;
+/**
+ * @brief Reads consecutive registers of an I2C device in one transaction.
+ *
+ * The device auto-increments the register address, so a single start,
+ * address, repeated start and stop fetches all len bytes, every byte but the
+ * last acknowledged. Failed attempts are repeated under the retry policy.
+ *
+ * @param dev The I2C device address (7-bit) to communicate with.
+ * @param start_reg The first register address to read.
+ * @param buf Buffer receiving the data, at least len bytes long.
+ * @param len Number of registers to read.
+ *
+ * @return I2C_OK, or the error of the last attempt; buf is then undefined.
+ */
+i2c_status_t i2c_read(uint8_t dev, uint8_t start_reg, uint8_t *buf, uint8_t len) {
+    PERF_SCOPE(PERF_I2C_READ);
 
-    // Send NACK to indicate that no more bytes will be read.
-    NACK;
+    return i2c_transact(dev, start_reg, buf, len, ONE);
+}
 
-    // Read the data from the I2C data register.
-    data = I2C1->D;
-    I2C_WAIT
+/**
+ * @brief Writes consecutive registers of an I2C device in one transaction.
+ *
+ * Failed attempts are repeated under the retry policy.
+ *
+ * @param dev The I2C device address (7-bit) to communicate with.
+ * @param start_reg The first register address to write.
+ * @param buf Data to write, len bytes long.
+ * @param len Number of registers to write.
+ *
+ * @return I2C_OK or the error of the last attempt.
+ */
+i2c_status_t i2c_write(uint8_t dev, uint8_t start_reg, const uint8_t *buf, uint8_t len) {
+    // The engines share one descriptor for both directions and never write buf here
+    return i2c_transact(dev, start_reg, (uint8_t *)buf, len, ZERO);
+}
 
-    // Stop the I2C communication.
-    I2C_M_STOP;
+/**
+ * @brief Replaces the retry policy of i2c_read() and i2c_write().
+ *
+ * @param policy New policy; an attempt count of 0 is treated as 1.
+ */
+void i2c_set_policy(const i2c_policy_t *policy) {
+    i2c_policy = *policy;
+    if (i2c_policy.attempts == 0) {
+        i2c_policy.attempts = ONE;
+    }
+}
 
-    // Read data from the I2C data register.
-    data = I2C1->D;
+/**
+ * @brief Reads a byte from a specific address of an I2C device.
+ *
+ * Legacy wrapper around i2c_read(); a failed read returns 0.
+ *
+ * @param dev The I2C device address (7-bit) to communicate with.
+ * @param address The register address from which to read the byte.
+ *
+ * @return The data byte read from the specified address of the I2C device.
+ */
+uint8_t i2c_read_byte(uint8_t dev, uint8_t address) {
+    uint8_t data = 0;
 
-    // Return the data read from the specified address of the I2C device.
+    if (i2c_read(dev, address, &data, 1) != I2C_OK) {
+        data = 0;
+    }
     return data;
 }
+
+/**
+ * @brief Reads consecutive registers of an I2C device in one transaction.
+ *
+ * Legacy wrapper around i2c_read() that drops the status.
+ *
+ * @param dev The I2C device address (7-bit) to communicate with.
+ * @param start_reg The first register address to read.
+ * @param buf Buffer receiving the data, at least len bytes long.
+ * @param len Number of registers to read.
+ */
+void i2c_read_burst(uint8_t dev, uint8_t start_reg, uint8_t *buf, uint8_t len) {
+    (void)i2c_read(dev, start_reg, buf, len);
+}
+
 /**
  * @brief Writes a byte of data to a specific address of an I2C device.
  *
- * This function performs a complete I2C transaction to write a byte of data
- * to the specified address of the given I2C device.
+ * Legacy wrapper around i2c_write() that drops the status.
  *
  * @param dev The I2C device address (7-bit) to communicate with.
  * @param address The register address where the data will be written.
  * @param data The byte of data to be written to the specified address.
- *
- *
- * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
- *        ARM Cortex-M based Microcontrollers", chapter 8.
  */
 void i2c_write_byte(uint8_t dev, uint8_t address, uint8_t data) {
-    // Set I2C to transmit mode.
-    I2C_TRAN;
-
-    // Start the I2C communication.
-    I2C_M_START;
-
-    // Send the I2C device address for writing.
-    I2C1->D = dev;
-    I2C_WAIT
-
-    // Send the register address where the data will be written.
-    I2C1->D =  address;
-    I2C_WAIT
+    (void)i2c_write(dev, address, &data, 1);
+}
 
-    // Send the byte of data to be written to the specified address.
-    I2C1->D = data;
-    I2C_WAIT
+/**
+ * @brief Copies the bus error counters.
+ *
+ * The ISR updates the counters, so the copy is taken with interrupts masked.
+ *
+ * @param stats Receives the counters.
+ */
+void i2c_stats_get(i2c_stats_t *stats) {
+    uint32_t primask = __get_PRIMASK();
 
-    // Stop the I2C communication to complete the write operation.
-    I2C_M_STOP;
+    __disable_irq();
+    *stats = i2c_stats;
+    __set_PRIMASK(primask);
 }
 
+/**
+ * @brief Clears the bus error counters.
+ */
+void i2c_stats_reset(void) {
+    uint32_t primask = __get_PRIMASK();
 
+    __disable_irq();
+    memset(&i2c_stats, 0, sizeof(i2c_stats));
+    __set_PRIMASK(primask);
+}
@@ -17,6 +17,97 @@
 
 #include <stdint.h>
 
+/**
+ * @brief PTE pins carrying the I2C1 bus, switched to GPIO for bus recovery.
+ */
+#define I2C_SDA_PIN     (0)
+#define I2C_SCL_PIN     (1)
+
+/**
+ * @brief Time a task waits for an interrupt-driven transfer before resetting the bus.
+ */
+#define I2C_TIMEOUT_MS  (5)
+
+/**
+ * @brief NVIC priority of the I2C1 interrupt (0 highest .. 3 lowest on the M0+).
+ */
+#define I2C_IRQ_PRIORITY (2)
+
+/**
+ * @brief Deadline for one polled byte; 400 kHz needs 23 us, the rest is for stretching.
+ */
+#define I2C_BYTE_TIMEOUT_US  (200)
+
+/**
+ * @brief Approximate core cycles per iteration of a polled wait loop.
+ */
+#define I2C_SPIN_CYCLES      (8)
+
+/**
+ * @brief SCL pulses clocked out to make a stuck slave release SDA (8 data + ACK).
+ */
+#define I2C_RECOVERY_CLOCKS  (9)
+
+/**
+ * @brief Half period of the bit-banged recovery clock (100 kHz).
+ */
+#define I2C_RECOVERY_HALF_US (5)
+
+/**
+ * @brief Worst-case duration of i2c_recover(): one settling half period, each
+ *        clock's two half periods plus up to I2C_RECOVERY_CLOCKS stretch waits,
+ *        and the four half periods of the STOP; 520 us with the values above.
+ */
+#define I2C_RECOVERY_MAX_US  (I2C_RECOVERY_HALF_US * \
+        (5 + (I2C_RECOVERY_CLOCKS * (I2C_RECOVERY_CLOCKS + 2))))
+
+/**
+ * @brief Attempts per transaction and first backoff of the default retry policy.
+ */
+#define I2C_ATTEMPTS         (3)
+#define I2C_BACKOFF_MS       (1)
+
+/**
+ * @brief Buckets of the transaction latency histogram; bucket n counts
+ *        transactions under I2C_LATENCY_BASE_US << n, the last one the rest.
+ */
+#define I2C_LATENCY_BUCKETS  (8)
+#define I2C_LATENCY_BASE_US  (64)
+
+/**
+ * @enum i2c_status_t
+ * @brief Outcome of an I2C transaction.
+ */
+typedef enum {
+    I2C_OK,       /**< Transfer completed, every byte acknowledged */
+    I2C_NACK,     /**< Slave did not acknowledge an address/data byte */
+    I2C_ARB_LOST, /**< Arbitration lost on the bus */
+    I2C_TIMEOUT   /**< No completion before the deadline; the bus was recovered */
+} i2c_status_t;
+
+/**
+ * @struct i2c_policy_t
+ * @brief Retry policy of i2c_read() and i2c_write().
+ */
+typedef struct {
+    uint8_t attempts;    /**< Attempts per transaction, the first included */
+    uint16_t backoff_ms; /**< Wait before the first retry, doubled for each further one */
+} i2c_policy_t;
+
+/**
+ * @struct i2c_stats_t
+ * @brief Bus error counters, by cause.
+ */
+typedef struct {
+    uint32_t timeouts;         /**< Transfers or polled bytes past their deadline */
+    uint32_t arbitration_lost; /**< Transfers that lost arbitration */
+    uint32_t nacks;            /**< Address or data bytes not acknowledged */
+    uint32_t recoveries;       /**< Bus recoveries run by i2c_recover() */
+    uint32_t stuck;            /**< Recoveries that left SDA or SCL low */
+    uint32_t retries;          /**< Attempts repeated under the retry policy */
+    uint32_t latency[I2C_LATENCY_BUCKETS]; /**< Transaction latency histogram */
+} i2c_stats_t;
+
 /**
  * @brief Macro to set I2C module to master mode and generate a start condition.
  */
@@ -42,21 +133,6 @@
  */
 #define I2C_REC         I2C1->C1 &= ~I2C_C1_TX_MASK
 
-/**
- * @brief Macro to wait until the I2C bus is busy.
- */
-#define BUSY_ACK        while(I2C1->S & 0x01)
-
-/**
- * @brief Macro to wait until the I2C transmission is complete.
- */
-#define TRANS_COMP      while(!(I2C1->S & 0x80))
-
-/**
- * @brief Macro to wait using a custom I2C wait function.
- */
-#define I2C_WAIT        i2c_wait();
-
 /**
  * @brief Macro to set NACK (Not Acknowledge) in the I2C module.
  */
@@ -76,37 +152,67 @@
 void i2c_init(void);
 
 /**
- * @brief Function to generate a start condition on the I2C bus.
+ * @brief Function to free a bus held low by a slave and reset the I2C1 module.
  *
- * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
- *        ARM Cortex-M based Microcontrollers", chapter 8.
+ * Clocks SCL as a GPIO until SDA is released, drives a STOP and hands the pins
+ * back to I2C1. Bounded in time whatever the slave does.
+ * @return 1 if the bus is idle again, 0 if it is still stuck.
+ */
+uint8_t i2c_recover(void);
+
+/**
+ * @brief Function to copy the bus error counters.
+ * @param stats Receives a consistent snapshot of the counters.
  */
-void i2c_start(void);
+void i2c_stats_get(i2c_stats_t *stats);
 
 /**
- * @brief Function to set up I2C for reading from a specific device and address.
- * @param dev The I2C device address (7-bit).
- * @param address The register address to read from.
+ * @brief Function to clear the bus error counters.
+ */
+void i2c_stats_reset(void);
+
+/**
+ * @brief I2C1 interrupt handler driving the interrupt-based transfer engine.
+ */
+void I2C1_IRQHandler(void);
+
+/**
+ * @brief Function to read consecutive registers of an I2C device.
  *
- * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
- *        ARM Cortex-M based Microcontrollers", chapter 8.
+ * Every byte is checked for lost arbitration and the slave acknowledge, and a
+ * failed transaction is repeated under the retry policy. Once the scheduler is
+ * running the calling task blocks on a task notification while the I2C1
+ * interrupt drives the transfer; before that the bus is polled.
+ * @param dev The I2C device address (7-bit) to communicate with.
+ * @param start_reg The first register address to read.
+ * @param buf Buffer receiving the data, at least len bytes long.
+ * @param len Number of registers to read.
+ * @return I2C_OK, or the error of the last attempt; buf is then undefined.
  */
-void i2c_read_setup(uint8_t dev, uint8_t address);
+i2c_status_t i2c_read(uint8_t dev, uint8_t start_reg, uint8_t *buf, uint8_t len);
 
 /**
- * @brief Function to perform a repeated I2C read operation.
- * @param isLastRead Indicates whether this is the last read in the sequence.
- *                   If true, a NACK (Not Acknowledge) is sent after the read.
- *                   If false, an ACK (Acknowledge) is sent after the read.
- * @return The data read from the I2C bus.
+ * @brief Function to write consecutive registers of an I2C device.
  *
- * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with
- *        ARM Cortex-M based Microcontrollers", chapter 8.
+ * Checked and retried like i2c_read().
+ * @param dev The I2C device address (7-bit) to communicate with.
+ * @param start_reg The first register address to write.
+ * @param buf Data to write, len bytes long.
+ * @param len Number of registers to write.
+ * @return I2C_OK or the error of the last attempt.
+ */
+i2c_status_t i2c_write(uint8_t dev, uint8_t start_reg, const uint8_t *buf, uint8_t len);
+
+/**
+ * @brief Function to replace the retry policy of i2c_read() and i2c_write().
+ * @param policy New policy; the default is I2C_ATTEMPTS and I2C_BACKOFF_MS.
  */
-uint8_t i2c_repeated_read(uint8_t isLastRead);
+void i2c_set_policy(const i2c_policy_t *policy);
 
 /**
  * @brief Function to read a byte from a specific address of an I2C device.
+ *
+ * Legacy wrapper around i2c_read(); returns 0 if the read failed.
  * @param dev The I2C device address (7-bit) to communicate with.
  * @param address The register address from which to read the byte.
  * @return The data byte read from the specified address of the I2C device.
@@ -116,8 +222,21 @@ uint8_t i2c_repeated_read(uint8_t isLastRead);
  */
 uint8_t i2c_read_byte(uint8_t dev, uint8_t address);
 
+/**
+ * @brief Function to read consecutive registers of an I2C device in one transaction.
+ *
+ * Legacy wrapper around i2c_read() that drops the status.
+ * @param dev The I2C device address (7-bit) to communicate with.
+ * @param start_reg The first register address to read.
+ * @param buf Buffer receiving the data, at least len bytes long.
+ * @param len Number of registers to read.
+ */
+void i2c_read_burst(uint8_t dev, uint8_t start_reg, uint8_t *buf, uint8_t len);
+
 /**
  * @brief Function to write a byte of data to a specific address of an I2C device.
+ *
+ * Legacy wrapper around i2c_write() that drops the status.
  * @param dev The I2C device address (7-bit) to communicate with.
  * @param address The register address where the data will be written.
  * @param data The byte of data to be written to the specified address.
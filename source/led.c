@@ -23,6 +23,7 @@
 
 #include "led.h"        // Include the LED header file
 #include <macros.h>     // Include the MACROS defined in the header file
+#include "perf.h"       // Include the timing scopes
 
 #define RED_LED_SHIFT   (18)  // Red LED pin on port B
 #define GREEN_LED_SHIFT (19)  // Green LED pin on port B
@@ -31,7 +32,95 @@
 #define PWM_PERIOD (48000)    // PWM period for LED control
 #define FULL_ON (PWM_PERIOD - 1) // Full brightness value for PWM
 #define FULL_OFF (0)           // No brightness value for PWM (LED off)
-#define ONE_PERCENT (0.01)    // one percent required for duty cycle calculation
+#define MAX_INTENSITY (255)   // Largest lit_led() intensity value
+
+// CnV for a duty cycle percentage, evaluated at compile time
+#define DUTY_CNV(p) ((uint16_t)(((PWM_PERIOD - ONE) * (p)) / HUNDRED))
+#define DUTY_CNV_10(p) DUTY_CNV(p), DUTY_CNV(p + 1), DUTY_CNV(p + 2), \
+		DUTY_CNV(p + 3), DUTY_CNV(p + 4), DUTY_CNV(p + 5), DUTY_CNV(p + 6), \
+		DUTY_CNV(p + 7), DUTY_CNV(p + 8), DUTY_CNV(p + 9)
+
+// Q16 scale turning a 0-255 intensity into CnV with a multiply and a shift
+#define INTENSITY_SCALE_Q16 (((uint32_t)(PWM_PERIOD - ONE) << SIXTEEN) / MAX_INTENSITY)
+#define INTENSITY_CNV(i) (((uint32_t)(i) * INTENSITY_SCALE_Q16) >> SIXTEEN)
+
+/**
+ * @brief CnV values for 0-100 % duty cycle.
+ *
+ * The Cortex-M0+ has neither an FPU nor a divider, so the duty cycle is looked
+ * up instead of computed on every LED update.
+ */
+static const uint16_t duty_cnv[HUNDRED + ONE] = {
+	DUTY_CNV_10(0), DUTY_CNV_10(10), DUTY_CNV_10(20), DUTY_CNV_10(30),
+	DUTY_CNV_10(40), DUTY_CNV_10(50), DUTY_CNV_10(60), DUTY_CNV_10(70),
+	DUTY_CNV_10(80), DUTY_CNV_10(90), DUTY_CNV(100)
+};
+
+/**
+ * @brief Clamps a value into the range [0, max].
+ *
+ * @param value The value to clamp.
+ * @param max Upper bound of the range.
+ * @return The clamped value.
+ */
+static inline uint32_t clamp(int value, int max) {
+	if (value < ZERO) {
+		return ZERO;
+	}
+	return (value > max) ? max : value;
+}
+
+/**
+ * @brief Index of each colour in led_base.
+ */
+enum {
+	LED_RED,
+	LED_GREEN,
+	LED_BLUE,
+	LED_CHANNELS
+};
+
+static volatile uint16_t led_base[LED_CHANNELS];  // CnV of the current colour
+static led_pattern_t pattern_buf[TWO];            // Active and pending patterns
+static volatile uint8_t active_buf;               // Buffer the interrupt plays
+static volatile uint8_t pattern_pending;          // Other buffer holds a new pattern
+static volatile uint8_t pattern_on;               // Interrupt owns the CnV registers
+static uint8_t step_index;                        // Step being played
+static uint16_t step_hold;                        // Overflows left in the step
+
+/**
+ * @brief Writes the current colour, scaled by a pattern level, to the timers.
+ *
+ * @param level Brightness in 1/256ths of the colour, LED_LEVEL_FULL for as is.
+ */
+static void led_apply(uint16_t level) {
+	TPM2->CONTROLS[ZERO].CnV = ((uint32_t)led_base[LED_RED] * level) >> EIGHT;
+	TPM2->CONTROLS[ONE].CnV = ((uint32_t)led_base[LED_GREEN] * level) >> EIGHT;
+	TPM0->CONTROLS[ONE].CnV = ((uint32_t)led_base[LED_BLUE] * level) >> EIGHT;
+}
+
+/**
+ * @brief Works out the CnV of one colour channel for dim_led().
+ *
+ * @param current The channel's current CnV, kept if mode is not recognised.
+ * @param dim Dim (DIM_LED) or brighten the channel when mode is CHANGE_LED.
+ * @param mode CHANGE_LED, KEEP_LED_BRIGHT or KEEP_LED_DIM.
+ * @param duty CnV for the requested duty cycle.
+ * @return The new CnV of the channel.
+ */
+static uint16_t channel_cnv(uint16_t current, int dim, int mode, uint32_t duty) {
+	if (mode == CHANGE_LED) {
+		// Dimming or brightening the LED
+		return dim ? (PWM_PERIOD - duty) : duty;
+	} else if (mode == KEEP_LED_BRIGHT) {
+		// keep led bright while transition
+		return PWM_PERIOD - ONE;
+	} else if (mode == KEEP_LED_DIM) {
+		// keep led dim while transition
+		return ZERO;
+	}
+	return current;
+}
 
 /**
  * @brief Initializes the RGB LED PWM functionality.
@@ -82,6 +171,11 @@ void Init_RGB_LED_PWM() {
 	TPM2->CONTROLS[ZERO].CnV = ZERO;
 	TPM2->CONTROLS[ONE].CnV = ZERO;
 
+	// Overflow interrupt steps LED patterns; TOIE is only set while one plays
+	NVIC_SetPriority(TPM2_IRQn, LED_IRQ_PRIORITY);
+	NVIC_ClearPendingIRQ(TPM2_IRQn);
+	NVIC_EnableIRQ(TPM2_IRQn);
+
 	// Start TPM
 	TPM0->SC |= TPM_SC_CMOD(ONE);
 	TPM2->SC |= TPM_SC_CMOD(ONE);
@@ -103,65 +197,25 @@ void Init_RGB_LED_PWM() {
  */
 void dim_led(int duty_cycle_percentage, int dim_red, int dim_green,
 		int dim_blue, int change_red, int change_green, int change_blue) {
-	// Change red LED intensity
-	if (change_red == CHANGE_LED) {
-		if (dim_red) {
-			// Dimming red LED
-			TPM2->CONTROLS[ZERO].CnV = PWM_PERIOD
-					- ((PWM_PERIOD - ONE)
-							* (ONE_PERCENT * duty_cycle_percentage));
-		} else {
-			// Brightening red LED
-			TPM2->CONTROLS[ZERO].CnV = (PWM_PERIOD - ONE)
-					* (ONE_PERCENT * duty_cycle_percentage);
-		}
-	} else if (change_red == KEEP_LED_BRIGHT) {
-		// keep led bright while transition
-		TPM2->CONTROLS[ZERO].CnV = PWM_PERIOD - ONE;
-	} else if (change_red == KEEP_LED_DIM) {
-		// keep led dim while transition
-		TPM2->CONTROLS[ZERO].CnV = ZERO;
-	}
+	// CnV for the requested duty cycle
+	uint32_t duty = duty_cnv[clamp(duty_cycle_percentage, HUNDRED)];
+	uint32_t primask = __get_PRIMASK();
+	PERF_SCOPE(PERF_DIM_LED);
 
-	// Change green LED intensity
-	if (change_green == CHANGE_LED) {
-		if (dim_green) {
-			// Dimming green LED
-			TPM2->CONTROLS[ONE].CnV = PWM_PERIOD
-					- ((PWM_PERIOD - ONE)
-							* (ONE_PERCENT * duty_cycle_percentage));
-		} else {
-			// Brightening green LED
-			TPM2->CONTROLS[ONE].CnV = (PWM_PERIOD - ONE)
-					* (ONE_PERCENT * duty_cycle_percentage);
-		}
-	} else if (change_green == KEEP_LED_BRIGHT) {
-		// keep led bright while transition
-		TPM2->CONTROLS[ONE].CnV = PWM_PERIOD - ONE;
-	} else if (change_green == KEEP_LED_DIM) {
-		// keep led dim while transition
-		TPM2->CONTROLS[ONE].CnV = ZERO;
-	}
+	// Keep the TPM overflow interrupt from sampling a half-updated colour
+	__disable_irq();
 
-	// Change blue LED intensity
-	if (change_blue == CHANGE_LED) {
-		if (dim_blue) {
-			// Dimming blue LED
-			TPM0->CONTROLS[ONE].CnV = PWM_PERIOD
-					- ((PWM_PERIOD - ONE)
-							* (ONE_PERCENT * duty_cycle_percentage));
-		} else {
-			// Brightening blue LED
-			TPM0->CONTROLS[ONE].CnV = (PWM_PERIOD - ONE)
-					* (ONE_PERCENT * duty_cycle_percentage);
-		}
-	} else if (change_blue == KEEP_LED_BRIGHT) {
-		// keep led bright while transition
-		TPM0->CONTROLS[ONE].CnV = PWM_PERIOD - ONE;
-	} else if (change_blue == KEEP_LED_DIM) {
-		// keep led dim while transition
-		TPM0->CONTROLS[ONE].CnV = ZERO;
+	// Change red, green and blue LED intensity
+	led_base[LED_RED] = channel_cnv(led_base[LED_RED], dim_red, change_red, duty);
+	led_base[LED_GREEN] = channel_cnv(led_base[LED_GREEN], dim_green, change_green, duty);
+	led_base[LED_BLUE] = channel_cnv(led_base[LED_BLUE], dim_blue, change_blue, duty);
+
+	// A running pattern applies the new colour at its next step
+	if (!pattern_on) {
+		led_apply(LED_LEVEL_FULL);
 	}
+
+	__set_PRIMASK(primask);
 }
 
 /**
@@ -171,14 +225,135 @@ void dim_led(int duty_cycle_percentage, int dim_red, int dim_green,
  * @param blue  Intensity value for the blue LED (0-255).
  */
 void lit_led(int red, int green, int blue){
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
     // Calculate PWM values based on input intensity values
+    led_base[LED_RED] = INTENSITY_CNV(clamp(red, MAX_INTENSITY));
+    led_base[LED_GREEN] = INTENSITY_CNV(clamp(green, MAX_INTENSITY));
+    led_base[LED_BLUE] = INTENSITY_CNV(clamp(blue, MAX_INTENSITY));
 
-    // Set the PWM value for the red LED
-    TPM2->CONTROLS[ZERO].CnV = (PWM_PERIOD - ONE) * ((float)red / 255.0f);
+    // Set the PWM values unless a running pattern owns them
+    if (!pattern_on) {
+        led_apply(LED_LEVEL_FULL);
+    }
 
-    // Set the PWM value for the green LED
-    TPM2->CONTROLS[ONE].CnV = (PWM_PERIOD - ONE) * ((float)green / 255.0f);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Starts playing a pattern, or replaces the one being played.
+ *
+ * A new pattern is swapped in at the next step boundary and continues from the
+ * following step, so a pattern refreshed on every sample keeps its rhythm.
+ *
+ * @param pattern The pattern to play; it is copied.
+ */
+void led_pattern_play(const led_pattern_t *pattern) {
+	uint32_t primask = __get_PRIMASK();
+
+	if (!pattern->length || pattern->length > LED_PATTERN_MAX_STEPS) {
+		return;
+	}
+
+	__disable_irq();
+
+	// Fill the buffer the interrupt is not reading
+	pattern_buf[!active_buf] = *pattern;
+
+	if (pattern_on) {
+		// Swap at the next step boundary
+		pattern_pending = ONE;
+	} else {
+		// Start immediately from the first step
+		active_buf = !active_buf;
+		pattern_pending = ZERO;
+		step_index = ZERO;
+		step_hold = pattern_buf[active_buf].steps[ZERO].hold;
+		led_apply(pattern_buf[active_buf].steps[ZERO].level);
+		pattern_on = ONE;
+		TPM2->SC |= TPM_SC_TOF_MASK;
+		TPM2->SC |= TPM_SC_TOIE_MASK;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Stops the running pattern and shows the current colour steadily.
+ */
+void led_pattern_stop(void) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if (pattern_on) {
+		TPM2->SC &= ~TPM_SC_TOIE_MASK;
+		pattern_on = ZERO;
+		pattern_pending = ZERO;
+		led_apply(LED_LEVEL_FULL);
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Blinks the current colour: on for on_ms, off for off_ms.
+ *
+ * @param on_ms Time the LED stays lit, in milliseconds.
+ * @param off_ms Time the LED stays dark, in milliseconds.
+ */
+void led_blink(uint16_t on_ms, uint16_t off_ms) {
+	led_pattern_t blink = { { { LED_LEVEL_FULL, LED_PATTERN_HOLD(on_ms) },
+			{ ZERO, LED_PATTERN_HOLD(off_ms) } }, TWO };
+
+	led_pattern_play(&blink);
+}
+
+/**
+ * @brief Reads the CnV values of the current colour, before any pattern level.
+ *
+ * @param red Receives the red channel CnV (TPM2 channel 0).
+ * @param green Receives the green channel CnV (TPM2 channel 1).
+ * @param blue Receives the blue channel CnV (TPM0 channel 1).
+ */
+void led_get_cnv(uint16_t *red, uint16_t *green, uint16_t *blue) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	*red = led_base[LED_RED];
+	*green = led_base[LED_GREEN];
+	*blue = led_base[LED_BLUE];
+	__set_PRIMASK(primask);
+}
 
-    // Set the PWM value for the blue LED
-    TPM0->CONTROLS[ONE].CnV = (PWM_PERIOD - ONE) * ((float)blue / 255.0f);
+/**
+ * @brief TPM2 overflow interrupt handler stepping the LED pattern.
+ *
+ * TPM2 overflows once per PWM period (every LED_PATTERN_TICK_MS). When the
+ * current step's hold count runs out, the next step's level is applied to the
+ * channel values; CnV is buffered, so it takes effect on the next period.
+ */
+void TPM2_IRQHandler(void) {
+	const led_pattern_t *pattern;
+
+	// Clear the overflow flag
+	TPM2->SC |= TPM_SC_TOF_MASK;
+
+	if (!pattern_on || --step_hold) {
+		return;
+	}
+
+	// Pick up a pattern queued by led_pattern_play()
+	if (pattern_pending) {
+		active_buf = !active_buf;
+		pattern_pending = ZERO;
+	}
+	pattern = &pattern_buf[active_buf];
+
+	// Advance to the next step, wrapping at the end of the pattern
+	if (++step_index >= pattern->length) {
+		step_index = ZERO;
+	}
+	step_hold = pattern->steps[step_index].hold;
+	led_apply(pattern->steps[step_index].level);
 }
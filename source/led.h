@@ -27,6 +27,32 @@
 #include <MKL25Z4.h>   // Include the MKL25Z4 microcontroller header file
 #include <stdint.h>     // Include the standard integer data types header
 
+#define LED_IRQ_PRIORITY (3)       // NVIC priority of the TPM2 pattern interrupt
+#define LED_PATTERN_TICK_MS (2)    // TPM2 overflow period: 48000 counts at 24 MHz
+#define LED_PATTERN_MAX_STEPS (8)  // Steps in one LED pattern
+#define LED_LEVEL_FULL (256)       // Pattern level showing the colour unscaled
+
+// Hold count of a pattern step lasting ms milliseconds (at least one period)
+#define LED_PATTERN_HOLD(ms) ((ms) < LED_PATTERN_TICK_MS ? 1 : (ms) / LED_PATTERN_TICK_MS)
+
+/**
+ * @struct led_step_t
+ * @brief One step of an LED pattern.
+ */
+typedef struct {
+	uint16_t level; /**< Brightness in 1/256ths of the current colour */
+	uint16_t hold;  /**< TPM2 overflows the step lasts */
+} led_step_t;
+
+/**
+ * @struct led_pattern_t
+ * @brief Looping sequence of brightness steps played by the TPM2 interrupt.
+ */
+typedef struct {
+	led_step_t steps[LED_PATTERN_MAX_STEPS]; /**< Steps, played in order */
+	uint8_t length;                          /**< Number of steps used */
+} led_pattern_t;
+
 /**
  * @brief Initializes the RGB LED PWM functionality.
  *
@@ -62,4 +88,41 @@ void dim_led(int duty_cycle_percentage, int dim_red, int dim_green,
  * @param blue  Intensity value for the blue LED (0-255).
  */
 void lit_led(int red, int green, int blue);
+
+/**
+ * @brief Starts playing a pattern, or replaces the one being played.
+ *
+ * The pattern scales the colour set by dim_led()/lit_led() and is stepped by the
+ * TPM2 overflow interrupt, so callers never wait for visual effects.
+ *
+ * @param pattern The pattern to play; it is copied.
+ */
+void led_pattern_play(const led_pattern_t *pattern);
+
+/**
+ * @brief Stops the running pattern and shows the current colour steadily.
+ */
+void led_pattern_stop(void);
+
+/**
+ * @brief Blinks the current colour: on for on_ms, off for off_ms.
+ *
+ * @param on_ms Time the LED stays lit, in milliseconds.
+ * @param off_ms Time the LED stays dark, in milliseconds.
+ */
+void led_blink(uint16_t on_ms, uint16_t off_ms);
+
+/**
+ * @brief Reads the CnV values of the current colour, before any pattern level.
+ *
+ * @param red Receives the red channel CnV (TPM2 channel 0).
+ * @param green Receives the green channel CnV (TPM2 channel 1).
+ * @param blue Receives the blue channel CnV (TPM0 channel 1).
+ */
+void led_get_cnv(uint16_t *red, uint16_t *green, uint16_t *blue);
+
+/**
+ * @brief TPM2 overflow interrupt handler stepping the LED pattern.
+ */
+void TPM2_IRQHandler(void);
 #endif /* LED_H_ */
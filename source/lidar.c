@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    lidar.c
+ * @brief   TF-Luna LiDAR driver
+ *
+ * This source file configures the TF-Luna over I2C and reads its
+ * measurements. All registers of a frame are read in one burst, so distance,
+ * amplitude and timestamp always belong to the same measurement.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "lidar.h"
+#include "task.h"
+#include "i2c.h"
+#include "macros.h"
+
+lidar_stats_t lidar_stats;
+
+static uint16_t last_tick; /**< Timestamp of the previous frame read. */
+
+/**
+ * @brief Configures the ranging mode and frame rate.
+ */
+void lidar_init(uint16_t rate_hz) {
+    uint16_t fps = (LIDAR_MODE == LIDAR_MODE_TRIGGER) ? ZERO : rate_hz;
+
+    i2c_write_byte(LIDAR_I2C_ADDRESS, LIDAR_REG_MODE, LIDAR_MODE);
+    i2c_write_byte(LIDAR_I2C_ADDRESS, LIDAR_REG_FPS_LOW, fps & 0xFF);
+    i2c_write_byte(LIDAR_I2C_ADDRESS, LIDAR_REG_FPS_HIGH, fps >> EIGHT);
+    i2c_write_byte(LIDAR_I2C_ADDRESS, LIDAR_REG_ENABLE, ONE);
+}
+
+/**
+ * @brief Starts one measurement (trigger mode only).
+ */
+void lidar_trigger(void) {
+    i2c_write_byte(LIDAR_I2C_ADDRESS, LIDAR_REG_TRIG_ONE_SHOT, ONE);
+}
+
+/**
+ * @brief Reads the latest frame in one burst.
+ */
+uint8_t lidar_read(lidar_frame_t *frame) {
+    uint8_t raw[LIDAR_FRAME_SIZE];
+    uint8_t fresh;
+
+    // A failed read leaves raw undefined; never let it reach the display
+    if (i2c_read(LIDAR_I2C_ADDRESS, LIDAR_REG_DIST_LOW, raw, LIDAR_FRAME_SIZE) != I2C_OK) {
+        lidar_stats.errors++;
+        return ZERO;
+    }
+    frame->distance = (uint16_t)(raw[LIDAR_REG_DIST_HIGH] << EIGHT) | raw[LIDAR_REG_DIST_LOW];
+    frame->amplitude = (uint16_t)(raw[LIDAR_REG_AMP_HIGH] << EIGHT) | raw[LIDAR_REG_AMP_LOW];
+    frame->temperature = (uint16_t)(raw[LIDAR_REG_TEMP_HIGH] << EIGHT) | raw[LIDAR_REG_TEMP_LOW];
+    frame->tick = (uint16_t)(raw[LIDAR_REG_TICK_HIGH] << EIGHT) | raw[LIDAR_REG_TICK_LOW];
+
+    fresh = frame->tick != last_tick;
+    last_tick = frame->tick;
+    return fresh;
+}
+
+/**
+ * @brief Checks that a frame's distance can be trusted.
+ */
+uint8_t lidar_valid(const lidar_frame_t *frame) {
+    if (frame->amplitude == LIDAR_AMP_OVEREXPOSED) {
+        lidar_stats.overexposed++;
+        return ZERO;
+    }
+    if (frame->amplitude < LIDAR_AMP_MIN) {
+        lidar_stats.weak++;
+        return ZERO;
+    }
+    if ((frame->distance < LIDAR_DIST_MIN_CM) || (frame->distance > LIDAR_DIST_MAX_CM)) {
+        lidar_stats.out_of_range++;
+        return ZERO;
+    }
+    return ONE;
+}
+
+/**
+ * @brief Triggers a measurement and blocks until its frame is read.
+ */
+uint8_t lidar_measure(lidar_frame_t *frame) {
+    uint8_t retries = ZERO;
+
+    if (LIDAR_MODE == LIDAR_MODE_TRIGGER) {
+        lidar_trigger();
+        vTaskDelay(pdMS_TO_TICKS(LIDAR_RANGING_MS));
+    }
+
+    while (!lidar_read(frame)) {
+        if (retries++ == LIDAR_READY_RETRIES) {
+            lidar_stats.stale++;
+            return ZERO;
+        }
+        lidar_stats.retries++;
+        vTaskDelay(pdMS_TO_TICKS(ONE));
+    }
+
+    lidar_stats.frames++;
+    return ONE;
+}
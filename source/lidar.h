@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    lidar.h
+ * @brief   TF-Luna LiDAR driver
+ *
+ * This header file declares the TF-Luna register map and the driver used by
+ * the reverse task. In trigger mode the sensor ranges once per
+ * lidar_trigger(), so every acquisition period yields exactly one fresh
+ * measurement; the sensor's frame timestamp tells a fresh frame from a
+ * repeated one.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef LIDAR_H_
+#define LIDAR_H_
+
+#include <stdint.h>
+
+#define LIDAR_I2C_ADDRESS (0x20) // 7-bit address 0x10, shifted for the write bit
+
+/* TF-Luna registers (product manual, I2C register list). */
+#define LIDAR_REG_DIST_LOW   (0x00)
+#define LIDAR_REG_DIST_HIGH  (0x01)
+#define LIDAR_REG_AMP_LOW    (0x02)
+#define LIDAR_REG_AMP_HIGH   (0x03)
+#define LIDAR_REG_TEMP_LOW   (0x04)
+#define LIDAR_REG_TEMP_HIGH  (0x05)
+#define LIDAR_REG_TICK_LOW   (0x06)
+#define LIDAR_REG_TICK_HIGH  (0x07)
+#define LIDAR_REG_MODE       (0x23) // 0: continuous ranging, 1: trigger mode
+#define LIDAR_REG_TRIG_ONE_SHOT (0x24) // Write 1 to range once in trigger mode
+#define LIDAR_REG_ENABLE     (0x25) // 1: ranging enabled
+#define LIDAR_REG_FPS_LOW    (0x26)
+#define LIDAR_REG_FPS_HIGH   (0x27)
+
+#define LIDAR_FRAME_SIZE (8) // Distance, amplitude, temperature and timestamp registers
+
+#define LIDAR_MODE_CONTINUOUS (0)
+#define LIDAR_MODE_TRIGGER    (1)
+#define LIDAR_MODE (LIDAR_MODE_TRIGGER) // Mode configured at boot
+
+#define LIDAR_RANGING_MS (3)       // Wait between a trigger and the read; a frame takes under 4 ms at 250 Hz
+#define LIDAR_READY_RETRIES (2)    // Extra 1 ms waits for a frame that is not ready yet
+
+/* Validity limits (product manual: distance is unreliable below amplitude 100 or at 65535). */
+#define LIDAR_AMP_MIN        (100)    // Weaker returns are noise
+#define LIDAR_AMP_OVEREXPOSED (0xFFFF) // Saturated receiver
+#define LIDAR_DIST_MIN_CM    (1)      // 0 is the sensor's "no target" value
+#define LIDAR_DIST_MAX_CM    (800)    // Rated range; anything beyond is a sentinel
+
+/**
+ * @struct lidar_frame_t
+ * @brief One TF-Luna measurement.
+ */
+typedef struct {
+    uint16_t distance;    /**< Distance in centimetres */
+    uint16_t amplitude;   /**< Signal strength */
+    uint16_t temperature; /**< Chip temperature in 0.01 degree C */
+    uint16_t tick;        /**< Sensor timestamp of the frame, in milliseconds */
+} lidar_frame_t;
+
+/**
+ * @struct lidar_stats_t
+ * @brief Counters of the driver.
+ */
+typedef struct {
+    uint32_t frames;       /**< Fresh frames read */
+    uint32_t retries;      /**< Reads repeated because the frame was not ready */
+    uint32_t stale;        /**< Periods that ended without a fresh frame */
+    uint32_t errors;       /**< Reads that failed on the bus after every retry */
+    uint32_t weak;         /**< Frames rejected for an amplitude under LIDAR_AMP_MIN */
+    uint32_t overexposed;  /**< Frames rejected for a saturated amplitude */
+    uint32_t out_of_range; /**< Frames rejected for a sentinel distance */
+} lidar_stats_t;
+
+extern lidar_stats_t lidar_stats; /**< Driver counters, cleared with acq_stats_reset(). */
+
+/**
+ * @brief Configures the ranging mode and frame rate.
+ *
+ * In trigger mode the frame rate is set to 0 so the sensor only ranges on
+ * request; in continuous mode it ranges at rate_hz.
+ *
+ * @param rate_hz Frame rate used in continuous mode.
+ */
+void lidar_init(uint16_t rate_hz);
+
+/**
+ * @brief Starts one measurement (trigger mode only).
+ */
+void lidar_trigger(void);
+
+/**
+ * @brief Reads the latest frame in one burst.
+ *
+ * @param frame Frame read; unchanged if the bus transaction failed.
+ * @return 1 if the frame is newer than the previous one read, 0 if it is not
+ *         or could not be read.
+ */
+uint8_t lidar_read(lidar_frame_t *frame);
+
+/**
+ * @brief Checks that a frame's distance can be trusted.
+ *
+ * Rejects weak and overexposed returns by amplitude and the sentinel
+ * distances the sensor reports when it has no target, counting each cause.
+ *
+ * @param frame Frame to check.
+ * @return 1 if the distance is valid, else 0.
+ */
+uint8_t lidar_valid(const lidar_frame_t *frame);
+
+/**
+ * @brief Triggers a measurement and blocks until its frame is read.
+ *
+ * Waits LIDAR_RANGING_MS, then up to LIDAR_READY_RETRIES more milliseconds
+ * for the timestamp to move. In continuous mode no trigger is sent.
+ *
+ * @param frame Frame read; the last one if no fresh frame arrived.
+ * @return 1 if the frame is fresh, 0 if the period ends with a repeated one.
+ */
+uint8_t lidar_measure(lidar_frame_t *frame);
+
+#endif /* LIDAR_H_ */
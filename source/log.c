@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file   log.c
+ * @brief  Deferred LOG backend
+ *
+ * LOG() stores a compact record (format pointer and integer arguments) in a
+ * ring buffer; a low priority task formats and prints the records, so the
+ * UART time no longer lands in the caller's loop.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include <stdarg.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "log.h"
+#include "macros.h"
+
+/**
+ * @struct log_entry_t
+ * @brief One deferred LOG call.
+ */
+typedef struct {
+    const char *fmt;              /**< Format string */
+    int32_t args[LOG_MAX_ARGS];   /**< Integer arguments */
+} log_entry_t;
+
+static log_entry_t ring[LOG_RING_SIZE];
+static volatile uint32_t head;    // Next slot written by log_record()
+static volatile uint32_t tail;    // Next slot printed by log_task()
+static volatile uint32_t dropped; // Records lost to a full ring
+static StaticSemaphore_t console_buffer;
+static SemaphoreHandle_t console; // Held while a record or a direct report is printed
+
+/**
+ * @brief Queues a log record for the log task to print.
+ *
+ * Only the format string pointer and up to LOG_MAX_ARGS integer arguments are
+ * stored, so a LOG costs a few word copies instead of a blocking console write.
+ * Safe to call from tasks and interrupts; a record is dropped when the ring is full.
+ *
+ * @param fmt Format string; must stay valid (a string literal).
+ * @param argc Number of integer arguments that follow.
+ */
+void log_record(const char *fmt, int argc, ...) {
+    log_entry_t *entry;
+    uint32_t primask;
+    va_list ap;
+
+    // Claim a slot; several tasks log, so the claim is made with interrupts off
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if ((head - tail) >= LOG_RING_SIZE) {
+        dropped++;
+        __set_PRIMASK(primask);
+        return;
+    }
+    entry = &ring[head % LOG_RING_SIZE];
+
+    entry->fmt = fmt;
+    va_start(ap, argc);
+    for (int i = 0; i < LOG_MAX_ARGS; i++) {
+        entry->args[i] = (i < argc) ? va_arg(ap, int) : 0;
+    }
+    va_end(ap);
+
+    // Publish the record to log_task()
+    head++;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Returns the number of records dropped because the ring was full.
+ */
+uint32_t log_dropped(void) {
+    return dropped;
+}
+
+/**
+ * @brief Creates the console lock shared by the log task and direct reports.
+ */
+void log_init(void) {
+    console = xSemaphoreCreateMutexStatic(&console_buffer);
+}
+
+/**
+ * @brief Takes the debug console for a report printed directly with PRINTF.
+ *
+ * The lock is a mutex, so a higher priority task waiting here lends its
+ * priority to the log task for the rest of its current record.
+ */
+void log_console_hold(void) {
+    if (console) {
+        xSemaphoreTake(console, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Hands the debug console back to the log task.
+ */
+void log_console_release(void) {
+    if (console) {
+        xSemaphoreGive(console);
+    }
+}
+
+/**
+ * @brief Low priority task formatting queued records onto the debug console.
+ *
+ * Wakes every LOG_DRAIN_PERIOD_MS, prints all pending records and reports
+ * any records dropped since the previous drain. Each record is printed
+ * under the console lock, so it never lands in the middle of a report.
+ *
+ * @param pvParameters Pointer to task parameters (not used).
+ */
+void log_task(void *pvParameters) {
+    uint32_t reported = 0;
+    log_entry_t *entry;
+
+    while (ONE) {
+        while (tail != head) {
+            entry = &ring[tail % LOG_RING_SIZE];
+            log_console_hold();
+            PRINTF(entry->fmt, entry->args[0], entry->args[1], entry->args[2],
+                    entry->args[3]);
+            log_console_release();
+            // Release the slot only once it has been printed
+            tail++;
+        }
+
+        if (dropped != reported) {
+            reported = dropped;
+            log_console_hold();
+            PRINTF("[log] %d records dropped\n\r", (int)reported);
+            log_console_release();
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+    }
+}
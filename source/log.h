@@ -21,11 +21,68 @@
 
 #ifndef LOG_H_
 #define LOG_H_
+#include <stdint.h>
 #include "fsl_debug_console.h"
 
+#define LOG_MAX_ARGS (4)        // Integer arguments stored per record
+#define LOG_RING_SIZE (16)      // Records buffered between drains
+#define LOG_DRAIN_PERIOD_MS (20) // Period of the log task
+#define LOG_STACK_SIZE (256)    // Stack of the log task, in words
+#define log_task_PRIORITY (tskIDLE_PRIORITY + 1)
+
+// Number of arguments after the format string, 0 to LOG_MAX_ARGS
+#define LOG_NARGS(...) LOG_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, N, ...) N
+
 #ifdef DEBUG
-#define LOG PRINTF  // Implementing LOG as abstraction of PRINTF in DEBUG mode
+// Implementing LOG as a deferred record in DEBUG mode; arguments must be integers
+#define LOG(fmt, ...) log_record(fmt, LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
 #else
 #define LOG(...)    // This will be ignored in RELEASE mode
 #endif
+
+/**
+ * @brief Queues a log record for the log task to print.
+ *
+ * Only the format string pointer and up to LOG_MAX_ARGS integer arguments are
+ * stored, so a LOG costs a few word copies instead of a blocking console write.
+ * Safe to call from tasks and interrupts; a record is dropped when the ring is full.
+ *
+ * @param fmt Format string; must stay valid (a string literal).
+ * @param argc Number of integer arguments that follow.
+ */
+void log_record(const char *fmt, int argc, ...);
+
+/**
+ * @brief Returns the number of records dropped because the ring was full.
+ */
+uint32_t log_dropped(void);
+
+/**
+ * @brief Creates the console lock shared by the log task and direct reports.
+ *
+ * Call before the scheduler starts, together with the creation of log_task().
+ */
+void log_init(void);
+
+/**
+ * @brief Takes the debug console for a report printed directly with PRINTF.
+ *
+ * Waits until the log task has finished the record it is printing and holds
+ * off further drains until log_console_release(), so report lines and LOG
+ * records are never interleaved. Does nothing unless log_init() was called.
+ */
+void log_console_hold(void);
+
+/**
+ * @brief Hands the debug console back to the log task.
+ */
+void log_console_release(void);
+
+/**
+ * @brief Low priority task formatting queued records onto the debug console.
+ * @param pvParameters Pointer to task parameters (not used).
+ */
+void log_task(void *pvParameters);
+
 #endif /* LOG_H_ */
@@ -39,9 +39,59 @@
 #include "pin_mux.h"
 #include <touch.h>
 #include "led.h"
+#include "power.h"
+#include "memwatch.h"
+#include "config.h"
+#include "lidar.h"
 #include "macros.h"
 #include "task.h"
 
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+/* Statically allocated kernel objects; their RAM is fixed at link time. */
+static StaticTask_t forward_tcb;
+static StackType_t forward_stack[STACK_SIZE];
+static StaticTask_t reverse_tcb;
+static StackType_t reverse_stack[STACK_SIZE];
+static StaticTask_t feedback_tcb;
+static StackType_t feedback_stack[STACK_SIZE];
+#ifdef DEBUG
+static StaticTask_t log_tcb;
+static StackType_t log_stack[LOG_STACK_SIZE];
+#endif
+static StaticTask_t idle_tcb;
+static StackType_t idle_stack[configMINIMAL_STACK_SIZE];
+static StaticTask_t timer_tcb;
+static StackType_t timer_stack[configTIMER_TASK_STACK_DEPTH];
+
+static StaticQueue_t sample_queue_buffer;
+static uint8_t sample_queue_storage[SAMPLE_QUEUE_LENGTH * sizeof(lidar_sample_t)];
+static StaticEventGroup_t gear_events_buffer;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*!
+ * @brief Provides the memory of the idle task.
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+        StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize) {
+    *ppxIdleTaskTCBBuffer = &idle_tcb;
+    *ppxIdleTaskStackBuffer = idle_stack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+/*!
+ * @brief Provides the memory of the timer service task.
+ */
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+        StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize) {
+    *ppxTimerTaskTCBBuffer = &timer_tcb;
+    *ppxTimerTaskStackBuffer = timer_stack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
 /*!
  * @brief Main function
  */
@@ -51,20 +101,54 @@ int main(void) {
     BOARD_BootClockRUN();
     BOARD_InitDebugConsole();
 
+    /* Report a stack overflow or failed allocation that reset the board. */
+    memwatch_init();
+
+    /* Load the stored configuration before the modules that use it. */
+    if (config_init() != kStatus_Success) {
+        PRINTF("Config store unavailable, using defaults\r\n");
+    }
+
     /* Initialize RGB LED PWM, touch, and I2C modules. */
     Init_RGB_LED_PWM();
     Touch_Init();
     i2c_init();
 
+    /* Put the TF-Luna in trigger mode so each period gets one fresh frame. */
+    lidar_init(ACQ_RATE_HZ);
+
+    /* Prepare the LPTMR time base of the tickless idle. */
+    power_init();
+
     /* Log a message indicating the start of the final project. */
     LOG("Final project\r\n");
 
+    /* Create the mailbox carrying the latest LiDAR sample to the feedback task. */
+    sample_queue = xQueueCreateStatic(SAMPLE_QUEUE_LENGTH, sizeof(lidar_sample_t),
+            sample_queue_storage, &sample_queue_buffer);
+    /* Name it for the scheduler trace. */
+    vQueueAddToRegistry(sample_queue, "sample_queue");
+
+    /* Create the gear event group; the gear starts in forward. */
+    gear_events = xEventGroupCreateStatic(&gear_events_buffer);
+
     /* Create tasks for forward and reverse states. */
-    xTaskCreate(forward, "Forward state", STACK_SIZE, NULL, forward_task_PRIORITY, &forward_handle);
-    xTaskCreate(reverse, "Reverse state", STACK_SIZE, NULL, reverse_task_PRIORITY, &reverse_handle);
+    forward_handle = xTaskCreateStatic(forward, "Forward state", STACK_SIZE, NULL,
+            forward_task_PRIORITY, forward_stack, &forward_tcb);
+    reverse_handle = xTaskCreateStatic(reverse, "Reverse state", STACK_SIZE, NULL,
+            reverse_task_PRIORITY, reverse_stack, &reverse_tcb);
+    feedback_handle = xTaskCreateStatic(feedback, "Feedback", STACK_SIZE, NULL,
+            feedback_task_PRIORITY, feedback_stack, &feedback_tcb);
+    memwatch_track(forward_handle, STACK_SIZE);
+    memwatch_track(reverse_handle, STACK_SIZE);
+    memwatch_track(feedback_handle, STACK_SIZE);
 
-    /* Suspend the reverse task initially. */
-    vTaskSuspend(reverse_handle);
+#ifdef DEBUG
+    /* Create the low priority task printing deferred LOG records. */
+    log_init();
+    memwatch_track(xTaskCreateStatic(log_task, "Log", LOG_STACK_SIZE, NULL,
+            log_task_PRIORITY, log_stack, &log_tcb), LOG_STACK_SIZE);
+#endif
 
     /* Start the FreeRTOS scheduler. */
     vTaskStartScheduler();
@@ -0,0 +1,146 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    memwatch.c
+ * @brief   Stack and heap telemetry
+ *
+ * This source file samples the stack high-water mark of the tracked tasks
+ * and the heap_4 watermark, and implements the stack overflow and malloc
+ * failed hooks. A hook writes a record to .noinit and resets the board; the
+ * record is printed on the next start-up.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include <string.h>
+#include "memwatch.h"
+#include "fsl_debug_console.h"
+#include "macros.h"
+
+/**
+ * @struct memwatch_task_t
+ * @brief One tracked task and its configured stack depth.
+ */
+typedef struct {
+    TaskHandle_t task; /**< Tracked task */
+    uint32_t depth;    /**< Stack depth in words */
+} memwatch_task_t;
+
+static memwatch_task_t tracked[MEMWATCH_MAX_TASKS];
+static uint8_t tracked_count;
+
+/* Survives the reset issued by the hooks */
+static memwatch_fault_t fault __attribute__((section(".noinit")));
+
+/**
+ * @brief Prints and clears the record of a fault that caused the last reset.
+ */
+void memwatch_init(void) {
+    if (fault.magic != MEMWATCH_FAULT_MAGIC) {
+        return;
+    }
+
+    fault.task[configMAX_TASK_NAME_LEN - ONE] = '\0';
+    PRINTF("Reset after %s in task %s at tick %d, %d bytes heap free\n\r",
+            fault.kind == MEMWATCH_STACK_OVERFLOW ? "stack overflow" : "failed allocation",
+            fault.task, (int)fault.tick, (int)fault.free_heap);
+    fault.magic = ZERO;
+}
+
+/**
+ * @brief Adds a task to the stack report.
+ */
+void memwatch_track(TaskHandle_t task, uint32_t depth) {
+    configASSERT(tracked_count < MEMWATCH_MAX_TASKS);
+    tracked[tracked_count].task = task;
+    tracked[tracked_count].depth = depth;
+    tracked_count++;
+}
+
+/**
+ * @brief Prints the stack use and recommended size of each tracked task and the heap watermark.
+ *
+ * The recommendation keeps a quarter of the peak use (at least
+ * MEMWATCH_MARGIN_MIN words) as headroom and never drops below
+ * configMINIMAL_STACK_SIZE. Peaks only cover the code paths exercised so far,
+ * so run both gears before trusting them.
+ */
+void memwatch_report(void) {
+    uint32_t used;
+    uint32_t margin;
+    uint32_t recommended;
+    uint8_t i;
+
+    for (i = ZERO; i < tracked_count; i++) {
+        used = tracked[i].depth - uxTaskGetStackHighWaterMark(tracked[i].task);
+        margin = used >> MEMWATCH_MARGIN_SHIFT;
+        if (margin < MEMWATCH_MARGIN_MIN) {
+            margin = MEMWATCH_MARGIN_MIN;
+        }
+        recommended = (used + margin + MEMWATCH_ROUND - ONE) & ~(uint32_t)(MEMWATCH_ROUND - ONE);
+        if (recommended < configMINIMAL_STACK_SIZE) {
+            recommended = configMINIMAL_STACK_SIZE;
+        }
+        PRINTF("MEM,%s,%d,%d,%d\n\r", pcTaskGetName(tracked[i].task),
+                (int)tracked[i].depth, (int)used, (int)recommended);
+    }
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    PRINTF("HEAP,%d,%d,%d\n\r", (int)configTOTAL_HEAP_SIZE, (int)xPortGetFreeHeapSize(),
+            (int)xPortGetMinimumEverFreeHeapSize());
+#endif
+}
+
+/**
+ * @brief Writes the fault record and resets the board.
+ *
+ * @param kind What went wrong.
+ * @param name Task concerned.
+ */
+static void memwatch_fault(memwatch_fault_kind_t kind, const char *name) {
+    taskDISABLE_INTERRUPTS();
+
+    fault.kind = kind;
+    fault.tick = xTaskGetTickCount();
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    fault.free_heap = xPortGetFreeHeapSize();
+#else
+    fault.free_heap = ZERO;
+#endif
+    strncpy(fault.task, name, configMAX_TASK_NAME_LEN);
+    fault.magic = MEMWATCH_FAULT_MAGIC;
+
+    NVIC_SystemReset();
+}
+
+/**
+ * @brief Kernel hook run when a context switch finds a corrupted stack.
+ *
+ * @param xTask Task that overflowed.
+ * @param pcTaskName Its name.
+ */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
+    memwatch_fault(MEMWATCH_STACK_OVERFLOW, pcTaskName);
+}
+
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+/**
+ * @brief Kernel hook run when pvPortMalloc fails.
+ */
+void vApplicationMallocFailedHook(void) {
+    // Before the scheduler starts there is no current task yet
+    memwatch_fault(MEMWATCH_MALLOC_FAILED,
+            xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED ?
+            "main" : pcTaskGetName(NULL));
+}
+#endif
@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    memwatch.h
+ * @brief   Stack and heap telemetry
+ *
+ * This header file declares the stack high-water-mark and heap watermark
+ * report, with recommended stack sizes, and the kernel hooks recording a
+ * stack overflow or failed allocation before the board is reset.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef MEMWATCH_H_
+#define MEMWATCH_H_
+
+#include "task.h"
+
+#define MEMWATCH_MAX_TASKS (8)     // Tasks whose stack can be tracked
+#define MEMWATCH_MARGIN_MIN (32)   // Smallest headroom kept above the peak, in words
+#define MEMWATCH_MARGIN_SHIFT (2)  // Headroom of a quarter of the peak use
+#define MEMWATCH_ROUND (8)         // Recommended sizes are multiples of 8 words
+#define MEMWATCH_FAULT_MAGIC (0x4D454D46) // "MEMF": a fault record survived the reset
+
+/**
+ * @enum memwatch_fault_kind_t
+ * @brief Kind of memory fault recorded before a reset.
+ */
+typedef enum {
+    MEMWATCH_STACK_OVERFLOW, /**< A task overran its stack */
+    MEMWATCH_MALLOC_FAILED   /**< pvPortMalloc could not satisfy a request */
+} memwatch_fault_kind_t;
+
+/**
+ * @struct memwatch_fault_t
+ * @brief Diagnostic record kept in .noinit across the reset following a fault.
+ */
+typedef struct {
+    uint32_t magic;                      /**< MEMWATCH_FAULT_MAGIC while the record is valid */
+    uint32_t kind;                       /**< A memwatch_fault_kind_t */
+    uint32_t tick;                       /**< Tick count when the fault was caught */
+    uint32_t free_heap;                  /**< Free heap bytes at that time */
+    char task[configMAX_TASK_NAME_LEN];  /**< Task that overflowed or was running */
+} memwatch_fault_t;
+
+/**
+ * @brief Prints and clears the record of a fault that caused the last reset.
+ *
+ * Call once at start-up, after the debug console is up.
+ */
+void memwatch_init(void);
+
+/**
+ * @brief Adds a task to the stack report.
+ *
+ * @param task Task to track.
+ * @param depth Stack depth it was created with, in words.
+ */
+void memwatch_track(TaskHandle_t task, uint32_t depth);
+
+/**
+ * @brief Prints the stack use and recommended size of each tracked task and the heap watermark.
+ *
+ * Lines are CSV, one per task and, with dynamic allocation, one for the heap:
+ * MEM,<task>,<depth>,<peak used>,<recommended>  (words)
+ * HEAP,<size>,<free>,<minimum ever free>        (bytes)
+ */
+void memwatch_report(void);
+
+#endif /* MEMWATCH_H_ */
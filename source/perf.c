@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    perf.c
+ * @brief   Hot-path timing scopes with cycle histograms
+ *
+ * This source file contains the SysTick timestamp, the scope table and its
+ * dump. In Release the table is left out and the functions do nothing, so
+ * stray calls still link.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include <string.h>
+#include "perf.h"
+#include "task.h"
+#include "fsl_debug_console.h"
+#include "macros.h"
+
+#ifdef DEBUG
+
+/**
+ * @struct perf_stats_t
+ * @brief Accumulated timings of one scope.
+ */
+typedef struct {
+    uint32_t count;                  /**< Completed runs */
+    uint32_t total;                  /**< Sum of all runs, in cycles */
+    uint32_t max;                    /**< Longest run, in cycles */
+    uint32_t histogram[PERF_BUCKETS]; /**< Runs by log2 of their cycles */
+} perf_stats_t;
+
+#define PERF_SCOPE_NAME(id, name) name,
+
+static const char *const perf_names[] = { PERF_SCOPES(PERF_SCOPE_NAME) };
+
+static perf_stats_t perf_table[PERF_SCOPE_COUNT];
+
+/**
+ * @brief Returns a cycle timestamp built from the tick count and SysTick.
+ *
+ * Safe in any context: the tick count and SysTick are read with interrupts
+ * masked, and a wrap whose tick interrupt is still pending is accounted for.
+ */
+uint32_t perf_now(void) {
+    uint32_t primask = __get_PRIMASK();
+    uint32_t ticks;
+    uint32_t val;
+
+    __disable_irq();
+    ticks = xTaskGetTickCount();
+    val = SysTick->VAL;
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        ticks++;
+        val = SysTick->VAL;
+    }
+    __set_PRIMASK(primask);
+
+    return (ticks * (SysTick->LOAD + ONE)) + (SysTick->LOAD - val);
+}
+
+/**
+ * @brief Adds one duration to a scope's statistics and histogram.
+ */
+void perf_record(perf_id_t id, uint32_t cycles) {
+    perf_stats_t *stats = &perf_table[id];
+    uint32_t primask = __get_PRIMASK();
+    uint32_t bucket = 0;
+
+    // floor(log2(cycles)), the last bucket collecting the rest
+    while ((bucket < (PERF_BUCKETS - ONE)) && (cycles >> (bucket + ONE))) {
+        bucket++;
+    }
+
+    __disable_irq();
+    stats->count++;
+    stats->total += cycles;
+    if (cycles > stats->max) {
+        stats->max = cycles;
+    }
+    stats->histogram[bucket]++;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Ends a PERF_SCOPE; called by the compiler when the scope is left.
+ */
+void perf_scope_exit(perf_scope_t *scope) {
+    perf_record(scope->id, perf_now() - scope->start);
+}
+
+/**
+ * @brief Prints every scope as one CSV line and clears the table.
+ */
+void perf_dump(void) {
+    perf_stats_t snap;
+    uint32_t primask;
+
+    for (uint32_t id = 0; id < PERF_SCOPE_COUNT; id++) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        snap = perf_table[id];
+        memset(&perf_table[id], 0, sizeof(perf_table[id]));
+        __set_PRIMASK(primask);
+
+        PRINTF("PERF,%s,%d,%d,%d", perf_names[id], (int)snap.count,
+                snap.count ? (int)(snap.total / snap.count) : 0, (int)snap.max);
+        for (uint32_t i = 0; i < PERF_BUCKETS; i++) {
+            PRINTF(",%d", (int)snap.histogram[i]);
+        }
+        PRINTF("\n\r");
+    }
+}
+
+#else
+
+uint32_t perf_now(void) {
+    return 0;
+}
+
+void perf_record(perf_id_t id, uint32_t cycles) {
+}
+
+void perf_dump(void) {
+}
+
+#endif /* DEBUG */
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    perf.h
+ * @brief   Hot-path timing scopes with cycle histograms
+ *
+ * This header file declares the timing scopes of the DEBUG build. The
+ * Cortex-M0+ has no DWT cycle counter, so a timestamp is the tick count
+ * times the SysTick reload plus the cycles SysTick has counted down inside
+ * the current tick. Every scope keeps a count, the total and worst cycles
+ * and a log2 histogram in a fixed table; perf_dump() prints them.
+ *
+ * PERF_SCOPE(id) times from its declaration to the end of the enclosing
+ * block (GCC cleanup attribute); PERF_BEGIN(id)/PERF_END(id) time a region
+ * of a block. In Release all three expand to nothing.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef PERF_H_
+#define PERF_H_
+
+#include <stdint.h>
+
+#define PERF_BUCKETS (20) // Bucket n counts durations in [2^n, 2^(n+1)) cycles, the last one the rest
+
+/**
+ * @brief Timed scopes: identifier and name printed by perf_dump().
+ */
+#define PERF_SCOPES(SCOPE) \
+    SCOPE(PERF_I2C_READ,     "i2c_read") \
+    SCOPE(PERF_TOUCH_ISR,    "TSI0_IRQHandler") \
+    SCOPE(PERF_DIM_LED,      "dim_led") \
+    SCOPE(PERF_FORWARD_LOOP, "forward") \
+    SCOPE(PERF_REVERSE_LOOP, "reverse")
+
+#define PERF_SCOPE_ID(id, name) id,
+
+/**
+ * @enum perf_id_t
+ * @brief Index of each scope in the table.
+ */
+typedef enum {
+    PERF_SCOPES(PERF_SCOPE_ID)
+    PERF_SCOPE_COUNT
+} perf_id_t;
+
+#ifdef DEBUG
+
+/**
+ * @struct perf_scope_t
+ * @brief Start of a running PERF_SCOPE.
+ */
+typedef struct {
+    perf_id_t id;   /**< Scope being timed */
+    uint32_t start; /**< Timestamp at entry, in cycles */
+} perf_scope_t;
+
+#define PERF_SCOPE(id) \
+    perf_scope_t perf_scope_##id __attribute__((cleanup(perf_scope_exit))) = { id, perf_now() }
+#define PERF_BEGIN(id) uint32_t perf_begin_##id = perf_now()
+#define PERF_END(id) perf_record(id, perf_now() - perf_begin_##id)
+
+#else
+
+#define PERF_SCOPE(id)
+#define PERF_BEGIN(id)
+#define PERF_END(id)
+
+#endif
+
+/**
+ * @brief Returns a cycle timestamp built from the tick count and SysTick.
+ *
+ * @return Core cycles since the scheduler started; wraps after 89 s at 48 MHz.
+ */
+uint32_t perf_now(void);
+
+/**
+ * @brief Adds one duration to a scope's statistics and histogram.
+ *
+ * @param id Scope.
+ * @param cycles Duration in core cycles.
+ */
+void perf_record(perf_id_t id, uint32_t cycles);
+
+#ifdef DEBUG
+/**
+ * @brief Ends a PERF_SCOPE; called by the compiler when the scope is left.
+ *
+ * @param scope The scope variable going out of scope.
+ */
+void perf_scope_exit(perf_scope_t *scope);
+#endif
+
+/**
+ * @brief Prints every scope as one CSV line and clears the table.
+ *
+ * PERF,<scope>,<count>,<mean cycles>,<max cycles>,<bucket 0>,...,<bucket 19>
+ */
+void perf_dump(void);
+
+#endif /* PERF_H_ */
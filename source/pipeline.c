@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    pipeline.c
+ * @brief   Distance-to-feedback processing of one LiDAR frame
+ *
+ * This source file contains the per-sample work shared by the reverse and
+ * feedback tasks and the replay harness.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "pipeline.h"
+#include "zone.h"
+#include "led.h"
+#include "log.h"
+#include "macros.h"
+
+/**
+ * @brief Forgets all samples, so the next session starts from scratch.
+ */
+void pipeline_reset(pipeline_acq_t *acq) {
+    filter_reset(&acq->filter);
+    ttc_reset(&acq->ttc);
+}
+
+/**
+ * @brief Turns a fresh frame into a sample for the feedback half.
+ *
+ * Frames the sensor flags as unreliable are dropped before the filter, so
+ * they neither reach the LED nor skew the filter state. The filtered
+ * distance feeds the time-to-collision estimator.
+ */
+uint8_t pipeline_sample(pipeline_acq_t *acq, const lidar_frame_t *frame,
+        uint32_t timestamp, lidar_sample_t *sample) {
+    if (!lidar_valid(frame)) {
+        return ZERO;
+    }
+
+    sample->amplitude = frame->amplitude;
+    sample->timestamp = timestamp;
+    sample->distance = filter_apply(&acq->filter, frame->distance);
+    sample->ttc = ttc_update(&acq->ttc, timestamp, sample->distance);
+    LOG("Distance : %d (raw %d) Amplitude : %d Speed : %d\n\r", sample->distance,
+            frame->distance, sample->amplitude, (int)acq->ttc.speed);
+
+    return ONE;
+}
+
+/**
+ * @brief Shows a sample on the RGB LED.
+ *
+ * The zone follows the distance with hysteresis and is escalated when the
+ * approach is fast; an escalated zone is drawn at its lower bound, its most
+ * urgent look. Blinking zones stay lit for percentage * 10 ms, then go dark
+ * for one sampling period; the TPM2 interrupt plays the pattern.
+ */
+uint8_t pipeline_render(uint8_t *zone, const lidar_sample_t *sample) {
+    uint8_t shown;
+    uint8_t percentage;
+
+    *zone = zone_classify(sample->distance, *zone);
+    shown = ttc_escalate(*zone, sample->ttc);
+    percentage = zone_render(shown,
+            (shown == *zone) ? sample->distance : zone_table[shown].lower);
+
+    if (zone_table[shown].blink) {
+        led_blink(percentage * TEN, THOUSAND / ACQ_RATE_HZ);
+    } else {
+        led_pattern_stop();
+    }
+
+    return shown;
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    pipeline.h
+ * @brief   Distance-to-feedback processing of one LiDAR frame
+ *
+ * This header file declares the two halves of the per-sample hot path: the
+ * acquisition half run by the reverse task (validity check, filter, time to
+ * collision) and the feedback half run by the feedback task (zone lookup,
+ * escalation, LED). The replay harness calls the same functions, so a
+ * recorded trace exercises exactly the code the tasks run.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <stdint.h>
+#include "task.h"
+#include "lidar.h"
+#include "filter.h"
+#include "ttc.h"
+
+/**
+ * @struct pipeline_acq_t
+ * @brief State of the acquisition half, owned by one reverse session.
+ */
+typedef struct {
+    distance_filter_t filter; /**< Outlier rejection and smoothing of the distance */
+    ttc_estimator_t ttc;      /**< Closing speed and time to collision */
+} pipeline_acq_t;
+
+/**
+ * @brief Forgets all samples, so the next session starts from scratch.
+ *
+ * @param acq Acquisition state.
+ */
+void pipeline_reset(pipeline_acq_t *acq);
+
+/**
+ * @brief Turns a fresh frame into a sample for the feedback half.
+ *
+ * @param acq Acquisition state.
+ * @param frame Frame read from the sensor.
+ * @param timestamp Time the frame was read, in microseconds.
+ * @param sample Filled in unless the frame is rejected.
+ * @return 1 if sample is valid, 0 if the frame failed lidar_valid().
+ */
+uint8_t pipeline_sample(pipeline_acq_t *acq, const lidar_frame_t *frame,
+        uint32_t timestamp, lidar_sample_t *sample);
+
+/**
+ * @brief Shows a sample on the RGB LED.
+ *
+ * @param zone Zone the previous sample was classified in, ZONE_NONE at
+ *             first; updated for the hysteresis of the next call.
+ * @param sample Sample to show.
+ * @return Zone shown on the LED after TTC escalation.
+ */
+uint8_t pipeline_render(uint8_t *zone, const lidar_sample_t *sample);
+
+#endif /* PIPELINE_H_ */
@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    power.c
+ * @brief   Tickless idle and low power modes
+ *
+ * This source file provides the LPTMR time base of the FreeRTOS tickless
+ * idle (freertos/fsl_tickless_lptmr.c) and its sleep hooks. The LPTMR counts
+ * the 1 kHz LPO, which keeps running in stop mode, so the idle task can
+ * suppress the tick for up to 65 s. In forward gear only the TSI is running
+ * and the idle task enters stop mode. In reverse gear the I2C interrupts end
+ * most idle periods early, and a tick resumed at 1 ms LPTMR resolution would
+ * lose up to a tick each time, so the tick keeps running and the idle task
+ * only waits with wfi.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "power.h"
+#include "fsl_clock.h"
+#include "fsl_smc.h"
+#include "fsl_lptmr.h"
+#include "fsl_debug_console.h"
+#include "macros.h"
+
+extern void vPortLptmrIsr(void);
+extern void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+
+power_stats_t power_stats[GEAR_REVERSE + ONE];
+
+static gear_state_t power_gear = GEAR_FORWARD; /**< Gear charged with the time. */
+static TickType_t power_since; /**< Tick count when power_gear was entered. */
+
+/**
+ * @brief LPTMR instance used by the tickless backend.
+ */
+LPTMR_Type *vPortGetLptrmBase(void) {
+    return LPTMR0;
+}
+
+/**
+ * @brief Interrupt of the LPTMR instance used by the tickless backend.
+ */
+IRQn_Type vPortGetLptmrIrqn(void) {
+    return LPTMR0_IRQn;
+}
+
+/**
+ * @brief Configures the LPTMR to count the 1 kHz LPO; call before the scheduler starts.
+ *
+ * The scheduler enables the interrupt when it sets up its tick.
+ */
+void power_init(void) {
+    SIM->SCGC5 |= SIM_SCGC5_LPTMR_MASK;
+
+    LPTMR0->CSR = ZERO;
+    LPTMR0->PSR = LPTMR_PSR_PCS(ONE) |   // LPO 1 kHz clock, running in stop mode
+                  LPTMR_PSR_PBYP_MASK;   // Prescaler bypassed, one count per ms
+    LPTMR0->CSR = LPTMR_CSR_TIE_MASK;    // Interrupt on compare
+
+    NVIC_SetPriority(LPTMR0_IRQn, POWER_LPTMR_IRQ_PRIORITY);
+}
+
+/**
+ * @brief Charges the time so far to the current gear and switches to a new one.
+ */
+void power_set_gear(gear_state_t gear) {
+    TickType_t now = xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+    power_stats[power_gear].elapsed += now - power_since;
+    power_since = now;
+    power_gear = gear;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Prints the time asleep and awake of each gear on the debug console.
+ */
+void power_stats_dump(void) {
+    power_stats_t snap[GEAR_REVERSE + ONE];
+    static const char *const names[] = { "forward", "reverse" };
+    uint8_t i;
+
+    // Charge the running interval before taking the snapshot
+    power_set_gear(power_gear);
+
+    taskENTER_CRITICAL();
+    for (i = ZERO; i <= GEAR_REVERSE; i++) {
+        snap[i] = power_stats[i];
+    }
+    taskEXIT_CRITICAL();
+
+    for (i = ZERO; i <= GEAR_REVERSE; i++) {
+        if (!snap[i].elapsed) {
+            continue;
+        }
+        PRINTF("Power %s: awake %d ms, asleep %d ms (%d%%), %d sleeps, %d in stop\n\r",
+                names[i],
+                (int)((snap[i].elapsed - snap[i].asleep) * (THOUSAND / configTICK_RATE_HZ)),
+                (int)(snap[i].asleep * (THOUSAND / configTICK_RATE_HZ)),
+                (int)(((uint64_t)snap[i].asleep * HUNDRED) / snap[i].elapsed),
+                (int)snap[i].sleeps, (int)snap[i].stops);
+    }
+}
+
+/**
+ * @brief Idle task sleep, called by the kernel in place of vPortSuppressTicksAndSleep().
+ *
+ * Suppresses the tick only in forward gear. In reverse gear the SysTick keeps
+ * running and the core waits for the next interrupt, which keeps the tick
+ * count exact for the acquisition timestamps and vTaskDelayUntil(). As in
+ * vPortSuppressTicksAndSleep(), the wfi runs with interrupts masked after
+ * eTaskConfirmSleepModeStatus(), so an interrupt readying a task just before
+ * it cannot leave the core asleep until the next tick; a pending interrupt
+ * still ends the wfi and is taken once they are unmasked.
+ */
+void power_idle(uint32_t idle) {
+    if (power_gear != GEAR_FORWARD) {
+        __disable_irq();
+        if (eTaskConfirmSleepModeStatus() != eAbortSleep) {
+            __DSB();
+            __WFI();
+        }
+        __enable_irq();
+        return;
+    }
+    vPortSuppressTicksAndSleep(idle);
+}
+
+/**
+ * @brief Tickless idle hook run with interrupts masked, just before sleeping.
+ *
+ * Only reached in forward gear. The core enters normal stop mode here: the LPTMR
+ * and the TSI keep running and either wakes it. The PLL stops with it, so the MCG
+ * comes back in PBE mode and is returned to PEE before the kernel resumes. Stop is
+ * skipped while the debug UART is still shifting out a character.
+ */
+uint32_t power_pre_sleep(uint32_t idle) {
+    power_stats[power_gear].sleeps++;
+
+    if (!(UART0->S1 & UART0_S1_TC_MASK)) {
+        return idle;
+    }
+
+    if (SMC_SetPowerModeStop(SMC, kSMC_PartialStop) == kStatus_Success) {
+        power_stats[power_gear].stops++;
+    }
+    // Back to sleep mode for the wfi of later idle periods
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+    if (CLOCK_GetMode() == kMCG_ModePBE) {
+        while (!(CLOCK_GetStatusFlags() & kMCG_Pll0LockFlag)) {
+        }
+        CLOCK_SetPeeMode();
+    }
+
+    return ZERO;
+}
+
+/**
+ * @brief Tickless idle hook run with interrupts masked, right after waking up.
+ *
+ * The LPTMR is still counting from the start of the sleep; if it already hit
+ * its compare value, the whole expected idle time was slept.
+ */
+void power_post_sleep(uint32_t idle) {
+    uint32_t slept;
+
+    if (LPTMR0->CSR & LPTMR_CSR_TCF_MASK) {
+        slept = idle - ONE;
+    } else {
+        slept = LPTMR_GetCurrentTimerCount(LPTMR0) / (configLPTMR_CLOCK_HZ / configTICK_RATE_HZ);
+    }
+    power_stats[power_gear].asleep += slept;
+}
+
+/**
+ * @brief LPTMR interrupt handler; ends a tickless sleep.
+ */
+void LPTMR0_IRQHandler(void) {
+    vPortLptmrIsr();
+}
@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    power.h
+ * @brief   Tickless idle and low power modes
+ *
+ * This header file declares the LPTMR time base used by the FreeRTOS
+ * tickless idle, the sleep hooks choosing between wait and stop mode, and
+ * the per-gear sleep statistics.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "task.h"
+
+#define POWER_LPTMR_IRQ_PRIORITY (3) // NVIC priority of the LPTMR wakeup interrupt
+
+/**
+ * @struct power_stats_t
+ * @brief Time spent asleep and awake while in one gear.
+ */
+typedef struct {
+    uint32_t elapsed; /**< Time spent in the gear, in ticks */
+    uint32_t asleep;  /**< Part of elapsed spent in wait or stop mode, in ticks */
+    uint32_t sleeps;  /**< Times the idle task suppressed the tick */
+    uint32_t stops;   /**< Sleeps spent in stop mode rather than wait mode */
+} power_stats_t;
+
+extern power_stats_t power_stats[]; /**< Sleep statistics indexed by gear_state_t. */
+
+/**
+ * @brief Configures the LPTMR to count the 1 kHz LPO; call before the scheduler starts.
+ */
+void power_init(void);
+
+/**
+ * @brief Charges the time so far to the current gear and switches to a new one.
+ *
+ * Stop mode is only entered in GEAR_FORWARD, where nothing but the TSI is running.
+ *
+ * @param gear Gear entered.
+ */
+void power_set_gear(gear_state_t gear);
+
+/**
+ * @brief Prints the time asleep and awake of each gear on the debug console.
+ */
+void power_stats_dump(void);
+
+/**
+ * @brief Idle task sleep, called by the kernel in place of vPortSuppressTicksAndSleep().
+ *
+ * Suppresses the tick in GEAR_FORWARD only; in reverse gear it waits with wfi
+ * and the tick keeps running.
+ *
+ * @param idle Ticks the kernel expects to stay idle.
+ */
+void power_idle(uint32_t idle);
+
+/**
+ * @brief Tickless idle hook run with interrupts masked, just before sleeping.
+ *
+ * @param idle Ticks the kernel expects to stay idle.
+ * @return 0 if the hook already slept in stop mode, else idle to let the kernel wait with wfi.
+ */
+uint32_t power_pre_sleep(uint32_t idle);
+
+/**
+ * @brief Tickless idle hook run with interrupts masked, right after waking up.
+ *
+ * @param idle Ticks the kernel expected to stay idle.
+ */
+void power_post_sleep(uint32_t idle);
+
+/**
+ * @brief LPTMR interrupt handler; ends a tickless sleep.
+ */
+void LPTMR0_IRQHandler(void);
+
+#endif /* POWER_H_ */
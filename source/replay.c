@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    replay.c
+ * @brief   Replay of a recorded LiDAR trace through the feedback pipeline
+ *
+ * This source file contains the trace table, generated at compile time from
+ * REPLAY_TRACE, and the harness feeding it through the pipeline.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "replay.h"
+#include "replay_trace.h"
+#include "pipeline.h"
+#include "runtime.h"
+#include "zone.h"
+#include "led.h"
+#include "fsl_debug_console.h"
+#include "macros.h"
+
+/**
+ * @struct replay_record_t
+ * @brief One recorded frame.
+ */
+typedef struct {
+    uint32_t time;      /**< Time of the frame in milliseconds */
+    uint16_t distance;  /**< Distance in centimetres */
+    uint16_t amplitude; /**< Signal strength */
+} replay_record_t;
+
+#define REPLAY_RECORD(time, distance, amplitude) { time, distance, amplitude },
+
+static const replay_record_t replay_trace[] = { REPLAY_TRACE(REPLAY_RECORD) };
+
+/**
+ * @brief Converts run-time stats clock counts to microseconds.
+ */
+static uint32_t replay_counts_to_us(uint32_t counts) {
+    return (counts << RUNTIME_PRESCALE_SHIFT) / (configCPU_CLOCK_HZ / (THOUSAND * THOUSAND));
+}
+
+/**
+ * @brief Replays the whole trace and prints the CnV timeline and statistics.
+ */
+void replay_run(void) {
+    const uint32_t frames = sizeof(replay_trace) / sizeof(replay_trace[0]);
+    pipeline_acq_t acq;
+    lidar_frame_t frame = { 0 };
+    lidar_sample_t sample;
+    uint8_t zone = ZONE_NONE;
+    uint8_t shown = ZONE_NONE;
+    uint8_t last_shown = ZONE_NONE;
+    uint16_t cnv[THREE];
+    uint16_t last_cnv[THREE] = { UINT16_MAX, UINT16_MAX, UINT16_MAX };
+    uint32_t rejected = 0;
+    uint32_t changes = 0;
+    uint32_t total = 0;
+    uint32_t worst = 0;
+    uint32_t start, elapsed;
+    uint8_t valid;
+    lidar_stats_t saved = lidar_stats;
+
+    pipeline_reset(&acq);
+
+    for (uint32_t i = 0; i < frames; i++) {
+        frame.distance = replay_trace[i].distance;
+        frame.amplitude = replay_trace[i].amplitude;
+        frame.tick = (uint16_t)replay_trace[i].time;
+
+        // Time the decision only; printing is excluded
+        start = runtime_counter();
+        valid = pipeline_sample(&acq, &frame, replay_trace[i].time * THOUSAND, &sample);
+        if (valid) {
+            shown = pipeline_render(&zone, &sample);
+        }
+        elapsed = runtime_counter() - start;
+
+        total += elapsed;
+        if (elapsed > worst) {
+            worst = elapsed;
+        }
+
+        if (!valid) {
+            rejected++;
+            continue;
+        }
+
+        if ((last_shown != ZONE_NONE) && (shown != last_shown)) {
+            changes++;
+        }
+        last_shown = shown;
+
+        // One line per colour change
+        led_get_cnv(&cnv[0], &cnv[1], &cnv[2]);
+        if ((cnv[0] != last_cnv[0]) || (cnv[1] != last_cnv[1]) || (cnv[2] != last_cnv[2])) {
+            PRINTF("CNV,%d,%d,%d,%d,%d\n\r", (int)replay_trace[i].time, shown,
+                    cnv[0], cnv[1], cnv[2]);
+            last_cnv[0] = cnv[0];
+            last_cnv[1] = cnv[1];
+            last_cnv[2] = cnv[2];
+        }
+    }
+
+    // Rejections of the trace are not the sensor's
+    lidar_stats = saved;
+
+    total = replay_counts_to_us(total);
+    PRINTF("REPLAY,%d,%d,%d,%d,%d,%d\n\r", (int)frames, (int)rejected, (int)changes,
+            total ? (int)(((uint64_t)frames * THOUSAND * THOUSAND) / total) : 0,
+            (int)(total / frames), (int)replay_counts_to_us(worst));
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    replay.h
+ * @brief   Replay of a recorded LiDAR trace through the feedback pipeline
+ *
+ * This header file declares the replay harness. Built with REPLAY set to 1,
+ * the reverse task replays the trace of replay_trace.h at the start of every
+ * reverse session, before it starts ranging. Each frame goes through
+ * pipeline_sample() and pipeline_render(), the code the reverse and feedback
+ * tasks run, as fast as the CPU allows, and the result is printed on the
+ * debug console:
+ *
+ * CNV,<trace time ms>,<zone shown>,<red CnV>,<green CnV>,<blue CnV>
+ *   once per change of the LED colour, so the timeline of two builds can be
+ *   diffed (grep '^CNV,') against a golden output.
+ * REPLAY,<frames>,<rejected>,<zone changes>,<frames/s>,<mean us>,<max us>
+ *   once at the end: throughput and per-frame decision latency, measured on
+ *   the run-time stats clock, printing excluded.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <stdint.h>
+
+#ifndef REPLAY
+#define REPLAY (0) // 1 replays the trace at the start of each reverse session
+#endif
+
+/**
+ * @brief Replays the whole trace and prints the CnV timeline and statistics.
+ *
+ * Runs in the calling task; the LED is left showing the last frame.
+ */
+void replay_run(void);
+
+#endif /* REPLAY_H_ */
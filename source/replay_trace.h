@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    replay_trace.h
+ * @brief   LiDAR trace replayed by replay_run()
+ *
+ * Rows are SAMPLE(time in ms, distance in cm, amplitude), one per frame, in
+ * time order. Replace the table with a field capture to replay it.
+ *
+ * This example is a synthetic 4 s manoeuvre at 100 Hz: standing at 3 m,
+ * reversing at 0.8 m/s, then at 1 m/s down to 40 cm. It contains two frames
+ * without a return, one single-frame outlier and one overexposed frame.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef REPLAY_TRACE_H_
+#define REPLAY_TRACE_H_
+
+#define REPLAY_TRACE(SAMPLE) \
+    SAMPLE(0, 300, 866) SAMPLE(10, 301, 864) SAMPLE(20, 299, 868) SAMPLE(30, 302, 862) \
+    SAMPLE(40, 300, 866) SAMPLE(50, 298, 871) SAMPLE(60, 301, 864) SAMPLE(70, 299, 868) \
+    SAMPLE(80, 300, 866) SAMPLE(90, 301, 864) SAMPLE(100, 300, 866) SAMPLE(110, 301, 864) \
+    SAMPLE(120, 299, 868) SAMPLE(130, 302, 862) SAMPLE(140, 300, 866) SAMPLE(150, 298, 871) \
+    SAMPLE(160, 301, 864) SAMPLE(170, 299, 868) SAMPLE(180, 300, 866) SAMPLE(190, 301, 864) \
+    SAMPLE(200, 300, 866) SAMPLE(210, 301, 864) SAMPLE(220, 299, 868) SAMPLE(230, 302, 862) \
+    SAMPLE(240, 300, 866) SAMPLE(250, 298, 871) SAMPLE(260, 301, 864) SAMPLE(270, 299, 868) \
+    SAMPLE(280, 300, 866) SAMPLE(290, 301, 864) SAMPLE(300, 300, 866) SAMPLE(310, 301, 864) \
+    SAMPLE(320, 299, 868) SAMPLE(330, 302, 862) SAMPLE(340, 300, 866) SAMPLE(350, 298, 871) \
+    SAMPLE(360, 301, 864) SAMPLE(370, 299, 868) SAMPLE(380, 300, 866) SAMPLE(390, 301, 864) \
+    SAMPLE(400, 300, 866) SAMPLE(410, 301, 864) SAMPLE(420, 299, 868) SAMPLE(430, 302, 862) \
+    SAMPLE(440, 300, 866) SAMPLE(450, 298, 871) SAMPLE(460, 301, 864) SAMPLE(470, 299, 868) \
+    SAMPLE(480, 300, 866) SAMPLE(490, 301, 864) SAMPLE(500, 300, 866) SAMPLE(510, 300, 866) \
+    SAMPLE(520, 297, 873) SAMPLE(530, 300, 866) SAMPLE(540, 297, 873) SAMPLE(550, 294, 880) \
+    SAMPLE(560, 296, 875) SAMPLE(570, 293, 882) SAMPLE(580, 294, 880) SAMPLE(590, 294, 880) \
+    SAMPLE(600, 292, 884) SAMPLE(610, 292, 884) SAMPLE(620, 289, 892) SAMPLE(630, 292, 884) \
+    SAMPLE(640, 289, 892) SAMPLE(650, 286, 899) SAMPLE(660, 288, 894) SAMPLE(670, 285, 901) \
+    SAMPLE(680, 286, 899) SAMPLE(690, 286, 899) SAMPLE(700, 284, 904) SAMPLE(710, 284, 904) \
+    SAMPLE(720, 281, 911) SAMPLE(730, 284, 904) SAMPLE(740, 281, 911) SAMPLE(750, 278, 919) \
+    SAMPLE(760, 280, 914) SAMPLE(770, 277, 922) SAMPLE(780, 278, 919) SAMPLE(790, 278, 919) \
+    SAMPLE(800, 276, 924) SAMPLE(810, 276, 924) SAMPLE(820, 273, 932) SAMPLE(830, 276, 924) \
+    SAMPLE(840, 273, 932) SAMPLE(850, 270, 940) SAMPLE(860, 272, 935) SAMPLE(870, 269, 943) \
+    SAMPLE(880, 270, 940) SAMPLE(890, 270, 940) SAMPLE(900, 268, 946) SAMPLE(910, 268, 946) \
+    SAMPLE(920, 265, 954) SAMPLE(930, 268, 946) SAMPLE(940, 265, 954) SAMPLE(950, 262, 963) \
+    SAMPLE(960, 264, 957) SAMPLE(970, 261, 966) SAMPLE(980, 262, 963) SAMPLE(990, 262, 963) \
+    SAMPLE(1000, 260, 969) SAMPLE(1010, 260, 969) SAMPLE(1020, 257, 978) SAMPLE(1030, 260, 969) \
+    SAMPLE(1040, 257, 978) SAMPLE(1050, 254, 987) SAMPLE(1060, 256, 981) SAMPLE(1070, 253, 990) \
+    SAMPLE(1080, 254, 987) SAMPLE(1090, 254, 987) SAMPLE(1100, 252, 993) SAMPLE(1110, 252, 993) \
+    SAMPLE(1120, 249, 1003) SAMPLE(1130, 252, 993) SAMPLE(1140, 249, 1003) SAMPLE(1150, 246, 1013) \
+    SAMPLE(1160, 248, 1006) SAMPLE(1170, 245, 1016) SAMPLE(1180, 246, 1013) SAMPLE(1190, 246, 1013) \
+    SAMPLE(1200, 0, 20) SAMPLE(1210, 0, 20) SAMPLE(1220, 241, 1029) SAMPLE(1230, 244, 1019) \
+    SAMPLE(1240, 241, 1029) SAMPLE(1250, 238, 1040) SAMPLE(1260, 240, 1033) SAMPLE(1270, 237, 1043) \
+    SAMPLE(1280, 238, 1040) SAMPLE(1290, 238, 1040) SAMPLE(1300, 236, 1047) SAMPLE(1310, 236, 1047) \
+    SAMPLE(1320, 233, 1058) SAMPLE(1330, 236, 1047) SAMPLE(1340, 233, 1058) SAMPLE(1350, 230, 1069) \
+    SAMPLE(1360, 232, 1062) SAMPLE(1370, 229, 1073) SAMPLE(1380, 230, 1069) SAMPLE(1390, 230, 1069) \
+    SAMPLE(1400, 228, 1077) SAMPLE(1410, 228, 1077) SAMPLE(1420, 225, 1088) SAMPLE(1430, 228, 1077) \
+    SAMPLE(1440, 225, 1088) SAMPLE(1450, 222, 1100) SAMPLE(1460, 224, 1092) SAMPLE(1470, 221, 1104) \
+    SAMPLE(1480, 222, 1100) SAMPLE(1490, 222, 1100) SAMPLE(1500, 220, 1109) SAMPLE(1510, 220, 1109) \
+    SAMPLE(1520, 217, 1121) SAMPLE(1530, 220, 1109) SAMPLE(1540, 217, 1121) SAMPLE(1550, 214, 1134) \
+    SAMPLE(1560, 216, 1125) SAMPLE(1570, 213, 1138) SAMPLE(1580, 214, 1134) SAMPLE(1590, 214, 1134) \
+    SAMPLE(1600, 212, 1143) SAMPLE(1610, 212, 1143) SAMPLE(1620, 209, 1156) SAMPLE(1630, 212, 1143) \
+    SAMPLE(1640, 209, 1156) SAMPLE(1650, 206, 1170) SAMPLE(1660, 208, 1161) SAMPLE(1670, 205, 1175) \
+    SAMPLE(1680, 206, 1170) SAMPLE(1690, 206, 1170) SAMPLE(1700, 204, 1180) SAMPLE(1710, 204, 1180) \
+    SAMPLE(1720, 201, 1195) SAMPLE(1730, 204, 1180) SAMPLE(1740, 201, 1195) SAMPLE(1750, 198, 1210) \
+    SAMPLE(1760, 200, 1200) SAMPLE(1770, 197, 1215) SAMPLE(1780, 198, 1210) SAMPLE(1790, 198, 1210) \
+    SAMPLE(1800, 196, 1220) SAMPLE(1810, 196, 1220) SAMPLE(1820, 193, 1236) SAMPLE(1830, 196, 1220) \
+    SAMPLE(1840, 193, 1236) SAMPLE(1850, 190, 1252) SAMPLE(1860, 192, 1241) SAMPLE(1870, 189, 1258) \
+    SAMPLE(1880, 190, 1252) SAMPLE(1890, 190, 1252) SAMPLE(1900, 188, 1263) SAMPLE(1910, 188, 1263) \
+    SAMPLE(1920, 185, 1281) SAMPLE(1930, 188, 1263) SAMPLE(1940, 185, 1281) SAMPLE(1950, 182, 1298) \
+    SAMPLE(1960, 184, 1286) SAMPLE(1970, 181, 1304) SAMPLE(1980, 182, 1298) SAMPLE(1990, 182, 1298) \
+    SAMPLE(2000, 290, 1311) SAMPLE(2010, 180, 1311) SAMPLE(2020, 177, 1329) SAMPLE(2030, 180, 1311) \
+    SAMPLE(2040, 177, 1329) SAMPLE(2050, 174, 1349) SAMPLE(2060, 176, 1336) SAMPLE(2070, 173, 1356) \
+    SAMPLE(2080, 174, 1349) SAMPLE(2090, 174, 1349) SAMPLE(2100, 172, 1362) SAMPLE(2110, 172, 1362) \
+    SAMPLE(2120, 169, 1383) SAMPLE(2130, 172, 1362) SAMPLE(2140, 169, 1383) SAMPLE(2150, 166, 1404) \
+    SAMPLE(2160, 168, 1390) SAMPLE(2170, 165, 1412) SAMPLE(2180, 166, 1404) SAMPLE(2190, 166, 1404) \
+    SAMPLE(2200, 164, 1419) SAMPLE(2210, 164, 1419) SAMPLE(2220, 161, 1442) SAMPLE(2230, 164, 1419) \
+    SAMPLE(2240, 161, 1442) SAMPLE(2250, 158, 1465) SAMPLE(2260, 160, 1450) SAMPLE(2270, 157, 1473) \
+    SAMPLE(2280, 158, 1465) SAMPLE(2290, 158, 1465) SAMPLE(2300, 156, 1482) SAMPLE(2310, 156, 1482) \
+    SAMPLE(2320, 153, 1507) SAMPLE(2330, 156, 1482) SAMPLE(2340, 153, 1507) SAMPLE(2350, 150, 1533) \
+    SAMPLE(2360, 152, 1515) SAMPLE(2370, 149, 1542) SAMPLE(2380, 150, 1533) SAMPLE(2390, 150, 1533) \
+    SAMPLE(2400, 148, 1551) SAMPLE(2410, 148, 1551) SAMPLE(2420, 145, 1579) SAMPLE(2430, 148, 1551) \
+    SAMPLE(2440, 145, 1579) SAMPLE(2450, 142, 1608) SAMPLE(2460, 144, 1588) SAMPLE(2470, 141, 1618) \
+    SAMPLE(2480, 142, 1608) SAMPLE(2490, 142, 1608) SAMPLE(2500, 140, 1628) SAMPLE(2510, 140, 1628) \
+    SAMPLE(2520, 137, 1659) SAMPLE(2530, 139, 1638) SAMPLE(2540, 136, 1670) SAMPLE(2550, 133, 1703) \
+    SAMPLE(2560, 135, 1681) SAMPLE(2570, 132, 1715) SAMPLE(2580, 132, 1715) SAMPLE(2590, 132, 1715) \
+    SAMPLE(2600, 130, 1738) SAMPLE(2610, 130, 1738) SAMPLE(2620, 127, 1774) SAMPLE(2630, 129, 1750) \
+    SAMPLE(2640, 126, 1787) SAMPLE(2650, 123, 1826) SAMPLE(2660, 125, 1800) SAMPLE(2670, 122, 1839) \
+    SAMPLE(2680, 122, 1839) SAMPLE(2690, 122, 1839) SAMPLE(2700, 120, 1866) SAMPLE(2710, 120, 1866) \
+    SAMPLE(2720, 117, 1909) SAMPLE(2730, 119, 1880) SAMPLE(2740, 116, 1924) SAMPLE(2750, 113, 1969) \
+    SAMPLE(2760, 115, 1939) SAMPLE(2770, 112, 1985) SAMPLE(2780, 112, 1985) SAMPLE(2790, 112, 1985) \
+    SAMPLE(2800, 110, 2018) SAMPLE(2810, 110, 2018) SAMPLE(2820, 107, 2069) SAMPLE(2830, 109, 2034) \
+    SAMPLE(2840, 106, 2086) SAMPLE(2850, 103, 2141) SAMPLE(2860, 105, 2104) SAMPLE(2870, 102, 2160) \
+    SAMPLE(2880, 102, 2160) SAMPLE(2890, 102, 2160) SAMPLE(2900, 100, 2200) SAMPLE(2910, 100, 2200) \
+    SAMPLE(2920, 97, 2261) SAMPLE(2930, 99, 2220) SAMPLE(2940, 96, 2283) SAMPLE(2950, 93, 2350) \
+    SAMPLE(2960, 95, 2305) SAMPLE(2970, 92, 2373) SAMPLE(2980, 92, 2373) SAMPLE(2990, 92, 2373) \
+    SAMPLE(3000, 90, 2422) SAMPLE(3010, 90, 2422) SAMPLE(3020, 87, 2498) SAMPLE(3030, 89, 2447) \
+    SAMPLE(3040, 86, 2525) SAMPLE(3050, 83, 2609) SAMPLE(3060, 85, 2552) SAMPLE(3070, 82, 2639) \
+    SAMPLE(3080, 82, 2639) SAMPLE(3090, 82, 2639) SAMPLE(3100, 80, 2700) SAMPLE(3110, 80, 2700) \
+    SAMPLE(3120, 77, 2797) SAMPLE(3130, 79, 2731) SAMPLE(3140, 76, 2831) SAMPLE(3150, 73, 2939) \
+    SAMPLE(3160, 75, 2866) SAMPLE(3170, 72, 2977) SAMPLE(3180, 72, 2977) SAMPLE(3190, 72, 2977) \
+    SAMPLE(3200, 70, 3057) SAMPLE(3210, 70, 3057) SAMPLE(3220, 67, 3185) SAMPLE(3230, 69, 3098) \
+    SAMPLE(3240, 66, 3230) SAMPLE(3250, 63, 3374) SAMPLE(3260, 65, 3276) SAMPLE(3270, 62, 3425) \
+    SAMPLE(3280, 62, 3425) SAMPLE(3290, 62, 3425) SAMPLE(3300, 12, 65535) SAMPLE(3310, 60, 3533) \
+    SAMPLE(3320, 57, 3708) SAMPLE(3330, 59, 3589) SAMPLE(3340, 56, 3771) SAMPLE(3350, 53, 3973) \
+    SAMPLE(3360, 55, 3836) SAMPLE(3370, 52, 4000) SAMPLE(3380, 52, 4000) SAMPLE(3390, 52, 4000) \
+    SAMPLE(3400, 50, 4000) SAMPLE(3410, 50, 4000) SAMPLE(3420, 47, 4000) SAMPLE(3430, 49, 4000) \
+    SAMPLE(3440, 46, 4000) SAMPLE(3450, 43, 4000) SAMPLE(3460, 45, 4000) SAMPLE(3470, 42, 4000) \
+    SAMPLE(3480, 42, 4000) SAMPLE(3490, 42, 4000) SAMPLE(3500, 40, 4000) SAMPLE(3510, 41, 4000) \
+    SAMPLE(3520, 39, 4000) SAMPLE(3530, 42, 4000) SAMPLE(3540, 40, 4000) SAMPLE(3550, 38, 4000) \
+    SAMPLE(3560, 41, 4000) SAMPLE(3570, 39, 4000) SAMPLE(3580, 40, 4000) SAMPLE(3590, 41, 4000) \
+    SAMPLE(3600, 40, 4000) SAMPLE(3610, 41, 4000) SAMPLE(3620, 39, 4000) SAMPLE(3630, 42, 4000) \
+    SAMPLE(3640, 40, 4000) SAMPLE(3650, 38, 4000) SAMPLE(3660, 41, 4000) SAMPLE(3670, 39, 4000) \
+    SAMPLE(3680, 40, 4000) SAMPLE(3690, 41, 4000) SAMPLE(3700, 40, 4000) SAMPLE(3710, 41, 4000) \
+    SAMPLE(3720, 39, 4000) SAMPLE(3730, 42, 4000) SAMPLE(3740, 40, 4000) SAMPLE(3750, 38, 4000) \
+    SAMPLE(3760, 41, 4000) SAMPLE(3770, 39, 4000) SAMPLE(3780, 40, 4000) SAMPLE(3790, 41, 4000) \
+    SAMPLE(3800, 40, 4000) SAMPLE(3810, 41, 4000) SAMPLE(3820, 39, 4000) SAMPLE(3830, 42, 4000) \
+    SAMPLE(3840, 40, 4000) SAMPLE(3850, 38, 4000) SAMPLE(3860, 41, 4000) SAMPLE(3870, 39, 4000) \
+    SAMPLE(3880, 40, 4000) SAMPLE(3890, 41, 4000) SAMPLE(3900, 40, 4000) SAMPLE(3910, 41, 4000) \
+    SAMPLE(3920, 39, 4000) SAMPLE(3930, 42, 4000) SAMPLE(3940, 40, 4000) SAMPLE(3950, 38, 4000) \
+    SAMPLE(3960, 41, 4000) SAMPLE(3970, 39, 4000) SAMPLE(3980, 40, 4000) SAMPLE(3990, 41, 4000)
+
+#endif /* REPLAY_TRACE_H_ */
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    runtime.c
+ * @brief   Per-task CPU run-time statistics
+ *
+ * This source file runs TPM1, which the LEDs leave free, as the FreeRTOS
+ * run-time stats clock and prints the CPU share of each task. TPM1 stops in
+ * stop mode, so percentages cover the time the core was clocked; time in
+ * stop mode is reported by power_stats_dump().
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "runtime.h"
+#include "task.h"
+#include "fsl_debug_console.h"
+#include "macros.h"
+
+#define RUNTIME_COUNTER_BITS (16) // Width of the TPM1 counter
+
+static volatile uint32_t overflows; /**< TPM1 overflows since runtime_init(). */
+
+/**
+ * @brief Starts the run-time stats clock; called by the scheduler as it starts.
+ */
+void runtime_init(void) {
+    SIM->SCGC6 |= SIM_SCGC6_TPM1_MASK;
+    // Same 48 MHz source the LED timers use
+    SIM->SOPT2 |= (SIM_SOPT2_TPMSRC(ONE) | SIM_SOPT2_PLLFLLSEL_MASK);
+
+    TPM1->SC = ZERO;
+    TPM1->CNT = ZERO;
+    TPM1->MOD = (ONE << RUNTIME_COUNTER_BITS) - ONE;
+    // Keep counting while the debugger halts the core
+    TPM1->CONF |= TPM_CONF_DBGMODE(THREE);
+
+    NVIC_SetPriority(TPM1_IRQn, RUNTIME_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(TPM1_IRQn);
+    NVIC_EnableIRQ(TPM1_IRQn);
+
+    TPM1->SC = TPM_SC_PS(RUNTIME_PRESCALE_SHIFT) | TPM_SC_TOIE_MASK | TPM_SC_CMOD(ONE);
+}
+
+/**
+ * @brief Returns the run-time stats clock.
+ */
+uint32_t runtime_counter(void) {
+    uint32_t masking_state = __get_PRIMASK();
+    uint32_t high;
+    uint32_t count;
+
+    __disable_irq();
+    high = overflows;
+    count = TPM1->CNT;
+    // The counter wrapped but the overflow interrupt has not been serviced yet
+    if (TPM1->SC & TPM_SC_TOF_MASK) {
+        high++;
+        count = TPM1->CNT;
+    }
+    __set_PRIMASK(masking_state);
+
+    return (high << RUNTIME_COUNTER_BITS) | count;
+}
+
+/**
+ * @brief Prints the CPU usage of every task since the previous report.
+ *
+ * uxTaskGetSystemState() is used instead of vTaskGetRunTimeStats(), which
+ * needs sprintf and a large text buffer.
+ */
+void runtime_report(void) {
+    static uint32_t last_counter[RUNTIME_MAX_TASKS + ONE]; /**< Task counters at the previous report, by task number. */
+    static uint32_t last_total; /**< Clock at the previous report. */
+    TaskStatus_t status[RUNTIME_MAX_TASKS];
+    UBaseType_t count;
+    UBaseType_t i;
+    uint32_t total;
+    uint32_t span;
+    uint32_t used;
+    uint32_t now = xTaskGetTickCount() * (THOUSAND / configTICK_RATE_HZ);
+
+    count = uxTaskGetSystemState(status, RUNTIME_MAX_TASKS, &total);
+    if (!count) {
+        PRINTF("RT: more than %d tasks\n\r", RUNTIME_MAX_TASKS);
+        return;
+    }
+    span = total - last_total;
+    last_total = total;
+    if (!span) {
+        return;
+    }
+
+    for (i = ZERO; i < count; i++) {
+        used = status[i].ulRunTimeCounter;
+        if (status[i].xTaskNumber <= RUNTIME_MAX_TASKS) {
+            used -= last_counter[status[i].xTaskNumber];
+            last_counter[status[i].xTaskNumber] = status[i].ulRunTimeCounter;
+        }
+        PRINTF("RT,%d,%s,%d,%d\n\r", (int)now, status[i].pcTaskName, (int)used,
+                (int)(((uint64_t)used * THOUSAND) / span));
+    }
+}
+
+/**
+ * @brief TPM1 overflow interrupt handler; extends the counter to 32 bits.
+ */
+void TPM1_IRQHandler(void) {
+    TPM1->SC |= TPM_SC_TOF_MASK;
+    overflows++;
+}
@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    runtime.h
+ * @brief   Per-task CPU run-time statistics
+ *
+ * This header file declares the run-time stats clock of FreeRTOS, a free
+ * running TPM1 counter extended to 32 bits, and the CPU usage report.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef RUNTIME_H_
+#define RUNTIME_H_
+
+#include <stdint.h>
+
+#define RUNTIME_IRQ_PRIORITY (3)        // NVIC priority of the TPM1 overflow interrupt
+#define RUNTIME_PRESCALE_SHIFT (7)      // TPM1 counts 48 MHz / 128 = 375 kHz
+#define RUNTIME_MAX_TASKS (8)           // Tasks the report keeps a previous count for
+#define RUNTIME_REPORT_PERIOD_MS (5000) // Period of the CPU report; 0 reports on demand only
+
+/**
+ * @brief Starts the run-time stats clock; called by the scheduler as it starts.
+ */
+void runtime_init(void);
+
+/**
+ * @brief Returns the run-time stats clock.
+ *
+ * @return Counts of the 375 kHz clock since the scheduler started; wraps after 3.1 hours.
+ */
+uint32_t runtime_counter(void);
+
+/**
+ * @brief Prints the CPU usage of every task since the previous report.
+ *
+ * Each task is printed as one CSV line, so the console log can be turned into
+ * a table over time with grep '^RT,':
+ * RT,<time ms>,<task>,<clock counts>,<CPU permille>
+ */
+void runtime_report(void);
+
+/**
+ * @brief TPM1 overflow interrupt handler; extends the counter to 32 bits.
+ */
+void TPM1_IRQHandler(void);
+
+#endif /* RUNTIME_H_ */
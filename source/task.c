@@ -20,88 +20,242 @@
 #include "pin_mux.h"
 #include <touch.h>
 #include "led.h"
+#include "zone.h"
+#include "lidar.h"
+#include "pipeline.h"
+#include "replay.h"
+#include "power.h"
+#include "runtime.h"
+#include "memwatch.h"
+#include "perf.h"
+#include "trace.h"
+#include "log.h"
 #include "macros.h"
 
-#define LIDAR_I2C_ADDRESS (0x20)
-#define DISTANCE_BYTE_HIGH (0x01)
-#define DISTANCE_BYTE_LOW  (0x00)
 /* Task handles for accessing the tasks later if needed */
 TaskHandle_t forward_handle;
 TaskHandle_t reverse_handle;
+TaskHandle_t feedback_handle;
+
+QueueHandle_t sample_queue;
+EventGroupHandle_t gear_events;
+
+acq_stats_t acq_stats = { 0, UINT32_MAX, 0, 0, 0, 0, ONE };
+feedback_stats_t feedback_stats;
 
 /**
- * @struct LED_RGB
- * @brief Structure to represent RGB LED settings based on touch value range.
+ * @brief Returns a microsecond timestamp built from the tick count and SysTick.
+ *
+ * The tick count alone only resolves 1 ms; the SysTick down-counter adds the
+ * time elapsed inside the current tick.
+ *
+ * @return Time since the scheduler started, in microseconds.
  */
-struct LED_RGB {
-    uint32_t min_sense_val; /**< Minimum touch sensor value for this range */
-    uint32_t max_sense_val; /**< Maximum touch sensor value for this range */
-    uint32_t delay;         /**< Delay time */
-    uint8_t r_dim;          /**< Red LED dim status */
-    uint8_t g_dim;          /**< Green LED dim status */
-    uint8_t b_dim;          /**< Blue LED dim status */
-    uint8_t r_mode;         /**< Red LED mode */
-    uint8_t g_mode;         /**< Green LED mode */
-    uint8_t b_mode;         /**< Blue LED mode */
-};
+static uint32_t acq_time_us(void) {
+    TickType_t ticks;
+    uint32_t val;
+
+    taskENTER_CRITICAL();
+    ticks = xTaskGetTickCount();
+    val = SysTick->VAL;
+    // The counter wrapped but the tick interrupt has not been serviced yet
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        ticks++;
+        val = SysTick->VAL;
+    }
+    taskEXIT_CRITICAL();
+
+    return (ticks * (THOUSAND / configTICK_RATE_HZ) * THOUSAND)
+            + ((SysTick->LOAD - val) / (configCPU_CLOCK_HZ / (THOUSAND * THOUSAND)));
+}
 
 /**
- * @var RGB_Table
- * @brief Array of LED_RGB structures representing translation from touch value to color.
+ * @brief Clears the acquisition statistics and restarts the period measurement.
  */
-struct LED_RGB RGB_Table[] = {
-    { 0, 90, 1, DIM_LED, DIM_LED, DIM_LED, CHANGE_LED, KEEP_LED_DIM, KEEP_LED_DIM },
-    { 91, 180, 0, DIM_LED, DIM_LED, DIM_LED, CHANGE_LED, CHANGE_LED, KEEP_LED_DIM },
-    { 180, 720, 0, DIM_LED, DIM_LED, DIM_LED, KEEP_LED_DIM, CHANGE_LED, KEEP_LED_DIM },
-    { 0, 0, 0, DIM_LED, DIM_LED, DIM_LED, KEEP_LED_DIM, KEEP_LED_DIM, KEEP_LED_DIM },
-    { 0, 0, 0, 0, 0, 0, 0, 0 }
-};
+void acq_stats_reset(void) {
+    taskENTER_CRITICAL();
+    acq_stats.samples = 0;
+    acq_stats.min_period = UINT32_MAX;
+    acq_stats.max_period = 0;
+    acq_stats.total_period = 0;
+    acq_stats.overruns = 0;
+    acq_stats.fast = 0;
+    acq_stats.restart = ONE;
+    feedback_stats.posted = 0;
+    feedback_stats.dropped = 0;
+    feedback_stats.rendered = 0;
+    feedback_stats.max_latency = 0;
+    feedback_stats.total_latency = 0;
+    lidar_stats.frames = 0;
+    lidar_stats.retries = 0;
+    lidar_stats.stale = 0;
+    lidar_stats.errors = 0;
+    lidar_stats.weak = 0;
+    lidar_stats.overexposed = 0;
+    lidar_stats.out_of_range = 0;
+    taskEXIT_CRITICAL();
+    i2c_stats_reset();
+}
+
+/**
+ * @brief Prints the acquisition rate and period jitter on the debug console.
+ */
+void acq_stats_dump(void) {
+    acq_stats_t snap;
+    feedback_stats_t pipe;
+    lidar_stats_t sensor;
+    i2c_stats_t bus;
+    uint32_t mean;
+
+    taskENTER_CRITICAL();
+    snap = acq_stats;
+    pipe = feedback_stats;
+    sensor = lidar_stats;
+    taskEXIT_CRITICAL();
+    i2c_stats_get(&bus);
+
+    PRINTF("I2C: %d timeouts, %d arbitration lost, %d NACKs, %d recoveries (%d stuck)\n\r",
+            (int)bus.timeouts, (int)bus.arbitration_lost, (int)bus.nacks,
+            (int)bus.recoveries, (int)bus.stuck);
+    PRINTF("I2C: %d retries, latency (us)", (int)bus.retries);
+    for (uint32_t i = 0; i < I2C_LATENCY_BUCKETS - 1; i++) {
+        PRINTF(" <%d:%d", I2C_LATENCY_BASE_US << i, (int)bus.latency[i]);
+    }
+    PRINTF(" >=%d:%d\n\r", I2C_LATENCY_BASE_US << (I2C_LATENCY_BUCKETS - 2),
+            (int)bus.latency[I2C_LATENCY_BUCKETS - 1]);
+
+    if (!snap.samples) {
+        PRINTF("Acquisition: no samples\n\r");
+        return;
+    }
+
+    mean = snap.total_period / snap.samples;
+    PRINTF("Acquisition: %d samples, period min %d mean %d max %d us (nominal %d), "
+            "jitter %d/+%d us, %d overruns, %d fast periods\n\r", (int)snap.samples,
+            (int)snap.min_period, (int)mean, (int)snap.max_period, ACQ_PERIOD_US,
+            (int)snap.min_period - ACQ_PERIOD_US, (int)snap.max_period - ACQ_PERIOD_US,
+            (int)snap.overruns, (int)snap.fast);
+
+    PRINTF("Sensor: %d fresh frames, %d late reads, %d stale periods, %d bus errors\n\r",
+            (int)sensor.frames, (int)sensor.retries, (int)sensor.stale, (int)sensor.errors);
+    PRINTF("Rejected: %d weak, %d overexposed, %d out of range\n\r",
+            (int)sensor.weak, (int)sensor.overexposed, (int)sensor.out_of_range);
+
+    if (pipe.rendered) {
+        PRINTF("Pipeline: %d posted, %d dropped, %d rendered, latency mean %d max %d us\n\r",
+                (int)pipe.posted, (int)pipe.dropped, (int)pipe.rendered,
+                (int)(pipe.total_latency / pipe.rendered), (int)pipe.max_latency);
+    }
+}
+
+/**
+ * @brief Records one sampling period in the acquisition statistics.
+ *
+ * @param period Time since the previous sample, in microseconds.
+ */
+static void acq_stats_record(uint32_t period) {
+    taskENTER_CRITICAL();
+    acq_stats.samples++;
+    acq_stats.total_period += period;
+    if (period < acq_stats.min_period) {
+        acq_stats.min_period = period;
+    }
+    if (period > acq_stats.max_period) {
+        acq_stats.max_period = period;
+    }
+    taskEXIT_CRITICAL();
+}
 
 /**
  * @brief Function to handle forward gear logic.
  *
  * This function is responsible for managing the logic associated with the forward gear state.
+ * It runs the gear state machine: each touch toggles between GEAR_FORWARD and
+ * GEAR_REVERSE. Entering reverse sets GEAR_REVERSE_BIT, which releases the reverse
+ * task; leaving it clears the bit and waits for GEAR_PARKED_BIT and
+ * GEAR_FEEDBACK_PARKED_BIT, so the reverse task always finishes its I2C transaction
+ * and the feedback task its rendering before the LED is switched off.
+ * Between shifts the task sleeps until the TSI interrupt reports a debounced touch,
+ * waking every RUNTIME_REPORT_PERIOD_MS without one to print the CPU and memory reports.
  *
  * @param pvParameters Pointer to task parameters (not used).
  */
 void forward(void *pvParameters) {
-    uint8_t reverse_gear_applied = 0; /**< Flag indicating if reverse gear is applied. */
-    uint8_t percentage = 0; /**< Percentage value calculated based on touch sensor. */
-    int touch_val = 0; /**< Touch sensor value. */
-    int touch_sensed = 1; /**< Flag indicating if touch has been sensed. */
+    gear_state_t gear = GEAR_FORWARD; /**< Current state of the gear state machine. */
+    const TickType_t report_period = RUNTIME_REPORT_PERIOD_MS ?
+            pdMS_TO_TICKS(RUNTIME_REPORT_PERIOD_MS) : portMAX_DELAY; /**< Longest sleep between CPU reports. */
+
+    // The kernel's own tasks exist once the scheduler runs
+    memwatch_track(xTaskGetIdleTaskHandle(), configMINIMAL_STACK_SIZE);
+    memwatch_track(xTimerGetTimerDaemonTaskHandle(), configTIMER_TASK_STACK_DEPTH);
+
+    // Hand touch scanning to the TSI interrupt, which notifies this task
+    Touch_Start_Events(xTaskGetCurrentTaskHandle());
 
     while (ONE) {
-        // Read touch sensor value
-        touch_val = Touch_Scan_LH();
-        LOG("Touch value %d\n\r", touch_val);
-
-        // Handle forward gear logic
-        if (touch_val > ZERO && !touch_sensed) {
-            touch_sensed = ONE;
-            reverse_gear_applied = !reverse_gear_applied;
-            if (!reverse_gear_applied) {
-                LOG("Gear shifted to forward\n\r");
-                dim_led(percentage, RGB_Table[3].r_dim, RGB_Table[3].g_dim,
-                        RGB_Table[3].b_dim, RGB_Table[3].r_mode,
-                        RGB_Table[3].g_mode, RGB_Table[3].b_mode);
-                vTaskSuspend(reverse_handle);
-            } else {
-                LOG("Gear shifted to reverse\n\r");
-            }
+        // Sleep until a debounced touch; report the CPU usage if none comes in time
+        if (!ulTaskNotifyTake(pdTRUE, report_period)) {
+            log_console_hold();
+            runtime_report();
+            memwatch_report();
+            log_console_release();
+            continue;
         }
+        PERF_BEGIN(PERF_FORWARD_LOOP);
 
-        if (touch_val < ZERO && touch_sensed) {
-            touch_sensed = ZERO;
-            LOG("touch sense reset\n\r");
-        }
+        // A new touch toggles the gear
+        switch (gear) {
+        case GEAR_FORWARD:
+            LOG("Gear shifted to reverse\n\r");
+            acq_stats_reset();
+            power_set_gear(GEAR_REVERSE);
+            xEventGroupSetBits(gear_events, GEAR_REVERSE_BIT);
+            gear = GEAR_REVERSE;
+            break;
 
-        // Resume reverse task if reverse gear is applied
-        if (reverse_gear_applied) {
-            vTaskResume(reverse_handle);
+        case GEAR_REVERSE:
+            LOG("Gear shifted to forward\n\r");
+            xEventGroupClearBits(gear_events, GEAR_REVERSE_BIT);
+            // Let the reverse task finish its transaction and the feedback task its rendering
+            if ((xEventGroupWaitBits(gear_events, GEAR_PARKED_BIT | GEAR_FEEDBACK_PARKED_BIT,
+                    pdFALSE, pdTRUE, pdMS_TO_TICKS(GEAR_PARK_TIMEOUT_MS))
+                    & (GEAR_PARKED_BIT | GEAR_FEEDBACK_PARKED_BIT))
+                    != (GEAR_PARKED_BIT | GEAR_FEEDBACK_PARKED_BIT)) {
+                LOG("Reverse or feedback task did not park\n\r");
+            }
+            // Discard any sample still waiting so the LED stays off
+            xQueueReset(sample_queue);
+            led_pattern_stop();
+            zone_render(zone_off, ZERO);
+            power_set_gear(GEAR_FORWARD);
+            gear = GEAR_FORWARD;
+            break;
         }
+        PERF_END(PERF_FORWARD_LOOP);
 
-        // Delay to control task execution frequency
-        vTaskDelay(TEN / portTICK_PERIOD_MS);
+        // Session over: calibrate and report outside the timed gear switch
+        if (gear == GEAR_FORWARD) {
+            // Reverse and feedback are parked, so the flash can be written
+            switch (Touch_Calibrate()) {
+            case TOUCH_CAL_STORED:
+                LOG("Touch thresholds calibrated and stored\n\r");
+                break;
+            case TOUCH_CAL_CLEARED:
+                LOG("Touch thresholds cleared\n\r");
+                break;
+            default:
+                break;
+            }
+            // Keep LOG records out of the middle of the reports
+            log_console_hold();
+            acq_stats_dump();
+            power_stats_dump();
+            runtime_report();
+            memwatch_report();
+            perf_dump();
+            trace_dump();
+            log_console_release();
+        }
     }
 }
 
@@ -110,42 +264,135 @@ void forward(void *pvParameters) {
  * @brief Function to handle reverse gear logic.
  *
  * This function is responsible for managing the logic associated with the reverse gear state.
+ * It triggers one LiDAR measurement per period at ACQ_RATE_HZ using vTaskDelayUntil and
+ * posts each fresh sample to sample_queue, overwriting any sample the feedback task has
+ * not rendered yet, so the sampling rate never depends on LED rendering. Each frame
+ * goes through pipeline_sample(): frames the sensor flags as unreliable are dropped,
+ * the rest pass the median/EMA filter, so a single noisy frame cannot flip the LED
+ * zone, and feed the time-to-collision estimator. While the TTC is under TTC_WARN_MS
+ * the period shortens to ACQ_FAST_RATE_HZ.
+ * Between transactions it checks GEAR_REVERSE_BIT and, once the gear leaves reverse,
+ * sets GEAR_PARKED_BIT and blocks until reverse is applied again.
  *
  * @param pvParameters Pointer to task parameters (not used).
  */
 void reverse(void *pvParameters) {
-    uint16_t distance = 0; /**< Distance value read from the I2C sensor. */
-    uint8_t percentage = 0; /**< Percentage value calculated based on distance. */
+    lidar_frame_t frame; /**< Measurement read from the TF-Luna. */
+    lidar_sample_t sample; /**< Sample handed to the feedback task. */
+    const TickType_t nominal = pdMS_TO_TICKS(THOUSAND / ACQ_RATE_HZ); /**< Sampling period in ticks. */
+    const TickType_t fast = pdMS_TO_TICKS(THOUSAND / ACQ_FAST_RATE_HZ); /**< Period while a collision is near. */
+    TickType_t period = nominal; /**< Period of the current iteration. */
+    TickType_t last_wake = xTaskGetTickCount(); /**< Wake time of the current period. */
+    uint32_t last_sample = 0; /**< Timestamp of the previous sample in microseconds. */
+    uint32_t now = 0; /**< Timestamp of the current sample in microseconds. */
+    pipeline_acq_t acq; /**< Filter and time-to-collision state of the session. */
 
     while (ONE) {
-        // Read distance from I2C sensor
-        distance = (uint16_t)i2c_read_byte(LIDAR_I2C_ADDRESS, DISTANCE_BYTE_HIGH);
-        distance = distance << EIGHT;
-        vTaskDelay(TEN / portTICK_PERIOD_MS);
-        distance |= (uint16_t)i2c_read_byte(LIDAR_I2C_ADDRESS, DISTANCE_BYTE_LOW);
-        LOG("Distance : %d\n\r", distance);
-
-        // Determine LED settings based on distance value
-        for (int i = 0; i < THREE; i++) {
-            if (distance > RGB_Table[i].min_sense_val && distance < RGB_Table[i].max_sense_val) {
-                percentage = ((float)(distance % NINTY) / NINTY) * HUNDRED;
-                dim_led(percentage, RGB_Table[i].r_dim, RGB_Table[i].g_dim,
-                        RGB_Table[i].b_dim, RGB_Table[i].r_mode,
-                        RGB_Table[i].g_mode, RGB_Table[i].b_mode);
-
-                // Add delay if specified by the RGB_Table configuration
-                if (RGB_Table[i].delay) {
-                    vTaskDelay((percentage * TEN) / portTICK_PERIOD_MS);
-                    dim_led(percentage, RGB_Table[3].r_dim, RGB_Table[3].g_dim,
-                            RGB_Table[3].b_dim, RGB_Table[3].r_mode,
-                            RGB_Table[3].g_mode, RGB_Table[3].b_mode);
-                }
-                break;
+        // Park between transactions while the gear is not in reverse
+        while (!(xEventGroupGetBits(gear_events) & GEAR_REVERSE_BIT)) {
+            xEventGroupSetBits(gear_events, GEAR_PARKED_BIT);
+            xEventGroupWaitBits(gear_events, GEAR_REVERSE_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+        }
+        xEventGroupClearBits(gear_events, GEAR_PARKED_BIT);
+        PERF_BEGIN(PERF_REVERSE_LOOP);
+
+        // Measure the achieved sampling period
+        now = acq_time_us();
+        if (acq_stats.restart) {
+            // First sample after a (re)start: re-seed instead of counting the gap
+            acq_stats.restart = ZERO;
+            last_wake = xTaskGetTickCount();
+            // Samples of the previous session must not bleed into this one
+            pipeline_reset(&acq);
+            period = nominal;
+#if REPLAY
+            // Benchmark the pipeline on the recorded trace before ranging
+            replay_run();
+            last_wake = xTaskGetTickCount();
+#endif
+        } else if (period == nominal) {
+            acq_stats_record(now - last_sample);
+        } else {
+            acq_stats.fast++;
+        }
+        last_sample = now;
+
+        // Range once and read the result; a repeated or unreliable frame is not posted
+        if (lidar_measure(&frame) && pipeline_sample(&acq, &frame, acq_time_us(), &sample)) {
+            // Sample faster while a collision is near
+            period = (sample.ttc < TTC_WARN_MS) ? fast : nominal;
+
+            // Hand the sample to the feedback task, replacing one it has not rendered yet
+            if (uxQueueMessagesWaiting(sample_queue)) {
+                feedback_stats.dropped++;
             }
+            xQueueOverwrite(sample_queue, &sample);
+            feedback_stats.posted++;
+        } else {
+            // Without a fresh TTC there is no reason to keep sampling fast
+            period = nominal;
+        }
+
+        // Count iterations that already used up their period
+        if ((xTaskGetTickCount() - last_wake) >= period) {
+            acq_stats.overruns++;
+        }
+        PERF_END(PERF_REVERSE_LOOP);
+
+        // Sleep until the start of the next sampling period
+        vTaskDelayUntil(&last_wake, period);
+    }
+}
+
+/**
+ * @brief Function to render the latest LiDAR sample on the RGB LED.
+ *
+ * This function owns dim_led() while in reverse gear. It blocks on sample_queue,
+ * and shows each sample through pipeline_render(): the distance picks a zone of
+ * zone_table, escalated by the sample's time to collision, and blinking zones are
+ * handed to the LED pattern engine, so it never sleeps for visual effects.
+ * Outside reverse gear it sets GEAR_FEEDBACK_PARKED_BIT and blocks until reverse is
+ * applied again, starting each session without zone hysteresis state. In reverse it
+ * waits at most GEAR_PARK_POLL_MS for a sample and drops a sample received after
+ * the gear left reverse, so the forward task switches the LED off last.
+ *
+ * @param pvParameters Pointer to task parameters (not used).
+ */
+void feedback(void *pvParameters) {
+    lidar_sample_t sample; /**< Latest sample posted by the reverse task. */
+    uint8_t zone = ZONE_NONE; /**< Zone the distance is classified in. */
+    uint32_t latency = 0; /**< Sample-to-LED latency in microseconds. */
+
+    while (ONE) {
+        // Park while the gear is not in reverse
+        if (!(xEventGroupGetBits(gear_events) & GEAR_REVERSE_BIT)) {
+            xEventGroupSetBits(gear_events, GEAR_FEEDBACK_PARKED_BIT);
+            xEventGroupWaitBits(gear_events, GEAR_REVERSE_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+            xEventGroupClearBits(gear_events, GEAR_FEEDBACK_PARKED_BIT);
+            // The zone of the previous session must not delay the first change of this one
+            zone = ZONE_NONE;
+        }
+
+        // Wait for the next sample from the reverse task, checking the gear regularly
+        if (!xQueueReceive(sample_queue, &sample, pdMS_TO_TICKS(GEAR_PARK_POLL_MS))) {
+            continue;
         }
 
-        // Delay to control task execution frequency
-        vTaskDelay(TEN / portTICK_PERIOD_MS);
+        // The gear left reverse while this task waited; the LED stays off
+        if (!(xEventGroupGetBits(gear_events) & GEAR_REVERSE_BIT)) {
+            continue;
+        }
+
+        // Pick the zone for this distance and show it
+        (void)pipeline_render(&zone, &sample);
+
+        // Record the sample-to-LED latency
+        latency = acq_time_us() - sample.timestamp;
+        feedback_stats.rendered++;
+        feedback_stats.total_latency += latency;
+        if (latency > feedback_stats.max_latency) {
+            feedback_stats.max_latency = latency;
+        }
     }
 }
 
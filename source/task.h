@@ -27,16 +27,107 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "timers.h"
+#include "queue.h"
+#include "event_groups.h"
 
 #define STACK_SIZE (512) // size of stack for each task
 
+/* LiDAR acquisition rate; the TF-Luna ranges at up to 250 Hz. */
+#define ACQ_RATE_HZ (100)
+#if (ACQ_RATE_HZ > 250)
+#error "ACQ_RATE_HZ exceeds the TF-Luna maximum frame rate of 250 Hz"
+#endif
+#define ACQ_PERIOD_US (1000000 / ACQ_RATE_HZ) // Nominal sampling period
+#define ACQ_FAST_RATE_HZ (200) // Rate used while the time to collision is short
+#if (ACQ_FAST_RATE_HZ > 250) || (ACQ_FAST_RATE_HZ < ACQ_RATE_HZ)
+#error "ACQ_FAST_RATE_HZ must lie between ACQ_RATE_HZ and 250 Hz"
+#endif
+
 /* Task priorities. */
 #define forward_task_PRIORITY (configMAX_PRIORITIES - 1)
 #define reverse_task_PRIORITY (configMAX_PRIORITIES - 1)
+#define feedback_task_PRIORITY (configMAX_PRIORITIES - 2)
+
+#define SAMPLE_QUEUE_LENGTH (1) // Renderer only ever needs the latest sample
+
+/* Gear event group bits. */
+#define GEAR_REVERSE_BIT (1 << 0) // Set while reverse gear is applied
+#define GEAR_PARKED_BIT  (1 << 1) // Set while the reverse task is idle between transactions
+#define GEAR_FEEDBACK_PARKED_BIT (1 << 2) // Set while the feedback task is idle outside reverse
+#define GEAR_PARK_TIMEOUT_MS (100) // Longest wait for the reverse and feedback tasks to park
+#define GEAR_PARK_POLL_MS (50) // Longest the feedback task waits for a sample before checking the gear
+#if (GEAR_PARK_POLL_MS >= GEAR_PARK_TIMEOUT_MS)
+#error "GEAR_PARK_POLL_MS must be shorter than GEAR_PARK_TIMEOUT_MS"
+#endif
+
+/**
+ * @enum gear_state_t
+ * @brief States of the gear state machine run by the forward task.
+ */
+typedef enum {
+    GEAR_FORWARD, /**< Forward gear: LiDAR parked, LED off */
+    GEAR_REVERSE  /**< Reverse gear: LiDAR sampled, LED shows distance */
+} gear_state_t;
+
+extern EventGroupHandle_t gear_events; /**< Gear state shared by the forward, reverse and feedback tasks. */
 
 /* Task handles for accessing the tasks later if needed */
 extern TaskHandle_t forward_handle; /**< Task handle for the 'forward' task. */
 extern TaskHandle_t reverse_handle; /**< Task handle for the 'reverse' task. */
+extern TaskHandle_t feedback_handle; /**< Task handle for the 'feedback' task. */
+
+/**
+ * @struct lidar_sample_t
+ * @brief One LiDAR measurement handed from the reverse task to the feedback task.
+ */
+typedef struct {
+    uint16_t distance;  /**< Distance in centimetres */
+    uint16_t amplitude; /**< Signal strength of the measurement */
+    uint32_t timestamp; /**< Time the frame was read, in microseconds */
+    uint32_t ttc;       /**< Time to collision in milliseconds, or TTC_NONE */
+} lidar_sample_t;
+
+extern QueueHandle_t sample_queue; /**< Latest-sample mailbox between reverse and feedback. */
+
+/**
+ * @struct feedback_stats_t
+ * @brief Counters of the sample pipeline between the reverse and feedback tasks.
+ */
+typedef struct {
+    uint32_t posted;        /**< Samples posted by the reverse task */
+    uint32_t dropped;       /**< Samples overwritten before being rendered */
+    uint32_t rendered;      /**< Samples rendered by the feedback task */
+    uint32_t max_latency;   /**< Worst sample-to-LED latency, in microseconds */
+    uint32_t total_latency; /**< Sum of sample-to-LED latencies, in microseconds */
+} feedback_stats_t;
+
+extern feedback_stats_t feedback_stats; /**< Pipeline counters of the current reverse session. */
+
+/**
+ * @struct acq_stats_t
+ * @brief Sampling period statistics of the reverse (acquisition) task.
+ */
+typedef struct {
+    uint32_t samples;      /**< Periods measured since the last reset */
+    uint32_t min_period;   /**< Shortest period seen, in microseconds */
+    uint32_t max_period;   /**< Longest period seen, in microseconds */
+    uint32_t total_period; /**< Sum of all periods, in microseconds */
+    uint32_t overruns;     /**< Iterations that took longer than a period */
+    uint32_t fast;         /**< Periods sampled at ACQ_FAST_RATE_HZ, not in the period stats */
+    uint8_t restart;       /**< Set to re-seed the period measurement */
+} acq_stats_t;
+
+extern acq_stats_t acq_stats; /**< Statistics of the current reverse session. */
+
+/**
+ * @brief Clears the acquisition, sensor and pipeline statistics and restarts the period measurement.
+ */
+void acq_stats_reset(void);
+
+/**
+ * @brief Prints the acquisition rate, period jitter, sensor and pipeline counters on the debug console.
+ */
+void acq_stats_dump(void);
 
 /* Task Prototypes */
 /**
@@ -51,4 +142,10 @@ void forward(void *pvParameters);
  */
 void reverse(void *pvParameters);
 
+/**
+ * @brief Function to render the latest LiDAR sample on the RGB LED.
+ * @param pvParameters Pointer to task parameters (not used).
+ */
+void feedback(void *pvParameters);
+
 #endif /* TASK_H_ */
@@ -24,10 +24,53 @@
 
 #include <touch.h>
 #include <macros.h>
+#include "config.h"
+#include "perf.h"
 
-#define TOUCH_OFFSET 600            // Offset value to be subtracted due to noise
 #define TOUCH_DATA (TSI0->DATA & 0xFFFF)  // Macro for extracting the count from
                                     // data register
+#define TOUCH_CHANNEL 10u           // TSI channel of the slider electrode
+
+static touch_tracker_t tracker;     // Baseline and debounce state of the electrode
+static TaskHandle_t touch_task;     // Task notified on a debounced touch
+
+/**
+ * @brief   Starting a software-triggered scan of the electrode.
+ *
+ * @return  Nothing
+ */
+static void Touch_Trigger(void)
+{
+    /* Assigning value from TSI channel 10 */
+    TSI0->DATA = TSI_DATA_TSICH(TOUCH_CHANNEL);
+
+    /* Software trigger to start the scan */
+    TSI0->DATA |= TSI_DATA_SWTS_MASK;
+}
+
+/**
+ * @brief   Polling one scan of the electrode to completion.
+ *
+ * @return  Raw touch sense count.
+ */
+static uint32_t Touch_Poll(void)
+{
+    uint32_t scan = 0;
+
+    Touch_Trigger();
+
+    /* Waiting for the scan to complete 32 times */
+    while (!(TSI0->GENCS & TSI_GENCS_EOSF_MASK))
+        ;
+
+    /* Getting touch sense value */
+    scan = TOUCH_DATA;
+
+    /* Clearing the end of scan flag */
+    TSI0->GENCS |= TSI_GENCS_EOSF_MASK;
+
+    return scan;
+}
 /**
  * @brief   Initializing Touch sense by enabling clock gating into the interface
  *          and setting bits in the general control and status register.
@@ -53,36 +96,233 @@ void Touch_Init()
                   TSI_GENCS_NSCN(31u) |     // Scanning the electrode 32 times
                   TSI_GENCS_TSIEN_MASK |    // Enabling the TSI module
                   TSI_GENCS_EOSF_MASK;      // Writing one to clear the end of scan flag
+
+    /* Seed the baseline with the untouched electrode */
+    uint32_t sum = 0;
+    for (int i = 0; i < TOUCH_CALIBRATION_SCANS; i++) {
+        sum += Touch_Poll();
+    }
+    touch_tracker_init(&tracker, sum / TOUCH_CALIBRATION_SCANS);
+
+    /* Thresholds tuned for this unit, if any were stored */
+    tracker.press = config_get(CONFIG_TOUCH_PRESS, TOUCH_PRESS_THRESHOLD);
+    tracker.release = config_get(CONFIG_TOUCH_RELEASE, TOUCH_RELEASE_THRESHOLD);
 }
 
 /**
- * @brief   Fetching Touch sense value from TSI DATA register.
+ * @brief   Initialising a tracker with a known untouched count and the
+ *          default thresholds.
  *
- * @return  Touch sense value after adjusting for offset.
+ * @param   t         Tracker to initialise.
+ * @param   baseline  Raw count of the untouched electrode.
  *
- * @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with ARM Cortex-M
- *             based Microcontrollers", chapter 2.
+ * @return  Nothing
  */
-int Touch_Scan_LH()
+void touch_tracker_init(touch_tracker_t *t, uint32_t baseline)
 {
-    unsigned int scan = 0;
+    t->baseline = baseline << TOUCH_BASELINE_SHIFT;
+    t->press = TOUCH_PRESS_THRESHOLD;
+    t->release = TOUCH_RELEASE_THRESHOLD;
+    t->peak = 0;
+    t->cal_peak = 0;
+    t->cal_presses = 0;
+    t->count = 0;
+    t->touched = 0;
+}
 
-    /* Assigning value from TSI channel 10 */
-    TSI0->DATA = TSI_DATA_TSICH(10u);
+/**
+ * @brief   Returning the tracked untouched count.
+ *
+ * @param   t  Tracker to read.
+ *
+ * @return  Baseline in raw counts.
+ */
+uint32_t touch_tracker_baseline(const touch_tracker_t *t)
+{
+    return t->baseline >> TOUCH_BASELINE_SHIFT;
+}
 
-    /* Software trigger to start the scan */
-    TSI0->DATA |= TSI_DATA_SWTS_MASK;
+/**
+ * @brief   Feeding one raw scan through the baseline and debounce logic.
+ *
+ * While the electrode is untouched the baseline follows the raw count with an
+ * exponential average, absorbing temperature and humidity drift. The touched
+ * state only changes after TOUCH_DEBOUNCE_SCANS consecutive scans beyond the
+ * press (or below the release) threshold.
+ *
+ * @param   t    Tracker to update.
+ * @param   raw  Raw count of the latest scan.
+ *
+ * @return  TOUCH_PRESSED or TOUCH_RELEASED on a debounced change, else TOUCH_NONE.
+ */
+touch_event_t touch_tracker_update(touch_tracker_t *t, uint32_t raw)
+{
+    uint32_t baseline = touch_tracker_baseline(t);
+    uint8_t beyond;
 
-    /* Waiting for the scan to complete 32 times */
-    while (!(TSI0->GENCS & TSI_GENCS_EOSF_MASK))
-        ;
+    if (t->touched) {
+        beyond = raw < baseline + t->release;
+        /* Remember the strongest touch for Touch_Calibrate() */
+        if ((raw > baseline + t->peak) && (raw - baseline <= UINT16_MAX)) {
+            t->peak = raw - baseline;
+        }
+    } else {
+        beyond = raw > baseline + t->press;
+    }
 
-    /* Getting touch sense value */
-    scan = TOUCH_DATA;
+    if (!beyond) {
+        t->count = 0;
+        /* Track slow drift of the untouched electrode */
+        if (!t->touched) {
+            t->baseline += ((int32_t)(raw << TOUCH_BASELINE_SHIFT) - (int32_t)t->baseline)
+                    >> TOUCH_BASELINE_SHIFT;
+        }
+        return TOUCH_NONE;
+    }
+
+    if (++t->count < TOUCH_DEBOUNCE_SCANS) {
+        return TOUCH_NONE;
+    }
+
+    t->count = 0;
+    t->touched = !t->touched;
+    if (t->touched) {
+        return TOUCH_PRESSED;
+    }
+
+    /* Keep the weakest of the presses measured for Touch_Calibrate() */
+    if (!t->cal_presses || (t->peak < t->cal_peak)) {
+        t->cal_peak = t->peak;
+    }
+    if (t->cal_presses < TOUCH_CAL_PRESSES) {
+        t->cal_presses++;
+    }
+    t->peak = 0;
+    return TOUCH_RELEASED;
+}
+
+/**
+ * @brief   Applying thresholds to the tracker read by the TSI interrupt.
+ *
+ * @param   press    Counts above baseline for a press.
+ * @param   release  Counts above baseline to stay pressed.
+ * @param   restart  Non-zero to start a new calibration.
+ *
+ * @return  Nothing
+ */
+static void Touch_Set_Thresholds(uint16_t press, uint16_t release, uint8_t restart)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    tracker.press = press;
+    tracker.release = release;
+    if (restart) {
+        tracker.cal_peak = 0;
+        tracker.cal_presses = 0;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief   Calibrating the thresholds once, or clearing them on a long hold.
+ *
+ * The press threshold becomes half and the release threshold a quarter of
+ * the weakest of TOUCH_CAL_PRESSES presses, so a light touch still shifts
+ * on an electrode that reads weaker than the defaults assume. Both are
+ * capped at the defaults, so one hard press can never make the electrode
+ * harder to use. Touch_Init() loads the stored values on every later boot.
+ *
+ * @return  What was done to the thresholds.
+ */
+touch_cal_t Touch_Calibrate(void)
+{
+    TickType_t held = xTaskGetTickCount();
+    uint16_t press, release;
+
+    /* Holding the electrode through the shift forgets the stored thresholds */
+    while (tracker.touched) {
+        if ((xTaskGetTickCount() - held) >= pdMS_TO_TICKS(TOUCH_RESET_HOLD_MS)) {
+            (void)config_clear(CONFIG_TOUCH_PRESS);
+            (void)config_clear(CONFIG_TOUCH_RELEASE);
+            Touch_Set_Thresholds(TOUCH_PRESS_THRESHOLD, TOUCH_RELEASE_THRESHOLD, ONE);
+            return TOUCH_CAL_CLEARED;
+        }
+        vTaskDelay(pdMS_TO_TICKS(TOUCH_RESET_POLL_MS));
+    }
+
+    /* Keep thresholds stored earlier; wait for enough presses to measure */
+    if (config_get(CONFIG_TOUCH_PRESS, ZERO) || (tracker.cal_presses < TOUCH_CAL_PRESSES)) {
+        return TOUCH_CAL_NONE;
+    }
+
+    press = tracker.cal_peak >> TOUCH_CAL_PRESS_SHIFT;
+    release = tracker.cal_peak >> TOUCH_CAL_RELEASE_SHIFT;
+    if (press > TOUCH_PRESS_THRESHOLD) {
+        press = TOUCH_PRESS_THRESHOLD;
+    }
+    if (release > TOUCH_RELEASE_THRESHOLD) {
+        release = TOUCH_RELEASE_THRESHOLD;
+    }
+    if (!release) {
+        return TOUCH_CAL_NONE;
+    }
+
+    if ((config_set(CONFIG_TOUCH_PRESS, press) != kStatus_Success)
+            || (config_set(CONFIG_TOUCH_RELEASE, release) != kStatus_Success)) {
+        return TOUCH_CAL_NONE;
+    }
+    Touch_Set_Thresholds(press, release, ZERO);
+
+    return TOUCH_CAL_STORED;
+}
+
+/**
+ * @brief   Handing the TSI to its end-of-scan interrupt.
+ *
+ * Scans then run back to back from the interrupt, and the given task is
+ * notified (vTaskNotifyGiveFromISR) on every debounced press.
+ *
+ * @param   task  Task to notify on a touch.
+ *
+ * @return  Nothing
+ */
+void Touch_Start_Events(TaskHandle_t task)
+{
+    touch_task = task;
+
+    /* Interrupt at the end of each scan rather than on out-of-range, and keep
+       scanning in stop mode so a touch wakes the core from tickless idle */
+    TSI0->GENCS |= TSI_GENCS_TSIIEN_MASK | TSI_GENCS_ESOR_MASK | TSI_GENCS_STPE_MASK;
+
+    NVIC_SetPriority(TSI0_IRQn, TOUCH_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(TSI0_IRQn);
+    NVIC_EnableIRQ(TSI0_IRQn);
+
+    Touch_Trigger();
+}
+
+/**
+ * @brief   TSI end-of-scan interrupt handler.
+ *
+ * Runs the scan through the tracker, notifies the touch task on a press and
+ * starts the next scan.
+ *
+ * @return  Nothing
+ */
+void TSI0_IRQHandler(void)
+{
+    BaseType_t woken = pdFALSE;
+    uint32_t scan = TOUCH_DATA;
+    PERF_SCOPE(PERF_TOUCH_ISR);
 
     /* Clearing the end of scan flag */
     TSI0->GENCS |= TSI_GENCS_EOSF_MASK;
 
-    /* Returning the touch sense value after adjusting for offset */
-    return (scan - TOUCH_OFFSET);
+    if (touch_tracker_update(&tracker, scan) == TOUCH_PRESSED && touch_task) {
+        vTaskNotifyGiveFromISR(touch_task, &woken);
+    }
+
+    Touch_Trigger();
+    portYIELD_FROM_ISR(woken);
 }
@@ -24,6 +24,44 @@
 #define TOUCH_H_
 
 #include <log.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define TOUCH_CALIBRATION_SCANS 8   // Scans averaged for the initial baseline
+#define TOUCH_BASELINE_SHIFT 4      // Baseline EMA weight 1/16, also its Q4 scale
+#define TOUCH_PRESS_THRESHOLD 200   // Default counts above baseline for a press
+#define TOUCH_RELEASE_THRESHOLD 100 // Default counts above baseline to stay pressed
+#define TOUCH_DEBOUNCE_SCANS 3      // Consecutive scans confirming a change
+#define TOUCH_CAL_PRESSES 4         // Presses measured before thresholds are calibrated
+#define TOUCH_CAL_PRESS_SHIFT 1     // Calibrated press threshold: half the weakest press
+#define TOUCH_CAL_RELEASE_SHIFT 2   // Calibrated release threshold: a quarter of it
+#define TOUCH_RESET_HOLD_MS 3000    // Hold on the shift to forward that clears the thresholds
+#define TOUCH_RESET_POLL_MS 50      // Period of the hold check
+#define TOUCH_IRQ_PRIORITY 3        // NVIC priority of the TSI interrupt
+
+/**
+ * @brief   Debounced state changes reported by the touch tracker.
+ */
+typedef enum {
+    TOUCH_NONE,     /**< No change */
+    TOUCH_PRESSED,  /**< Electrode became touched */
+    TOUCH_RELEASED  /**< Electrode was released */
+} touch_event_t;
+
+/**
+ * @brief   Baseline and debounce state of one electrode.
+ */
+typedef struct {
+    uint32_t baseline;  /**< Untouched count, Q TOUCH_BASELINE_SHIFT */
+    uint16_t press;     /**< Counts above baseline for a press */
+    uint16_t release;   /**< Counts above baseline to stay pressed */
+    uint16_t peak;      /**< Largest count above baseline of the current press */
+    uint16_t cal_peak;  /**< Weakest peak of the presses measured for calibration */
+    uint8_t cal_presses; /**< Presses measured for calibration */
+    uint8_t count;      /**< Consecutive scans beyond the threshold */
+    uint8_t touched;    /**< Debounced touch state */
+} touch_tracker_t;
 
 /**
  * @brief   Initializing Touch sense by enabling clock gating into the interface
@@ -37,13 +75,74 @@
 void Touch_Init();
 
 /**
- * @brief   Fetching Touch sense value from TSI DATA register.
+ * @brief   Initialising a tracker with a known untouched count and the
+ *          default thresholds.
  *
- * @return  Touch sense value after adjusting for offset.
+ * @param   t         Tracker to initialise.
+ * @param   baseline  Raw count of the untouched electrode.
  *
- *  @reference Alexander G. Dean, "Embedded_Systems_Fundamentals with ARM Cortex-M
- *             based Microcontrollers", chapter 2.
+ * @return  Nothing
+ */
+void touch_tracker_init(touch_tracker_t *t, uint32_t baseline);
+
+/**
+ * @brief   Returning the tracked untouched count.
+ *
+ * @param   t  Tracker to read.
+ *
+ * @return  Baseline in raw counts.
+ */
+uint32_t touch_tracker_baseline(const touch_tracker_t *t);
+
+/**
+ * @brief   Feeding one raw scan through the baseline and debounce logic.
+ *
+ * @param   t    Tracker to update.
+ * @param   raw  Raw count of the latest scan.
+ *
+ * @return  TOUCH_PRESSED or TOUCH_RELEASED on a debounced change, else TOUCH_NONE.
+ */
+touch_event_t touch_tracker_update(touch_tracker_t *t, uint32_t raw);
+
+/**
+ * @brief   Outcome of Touch_Calibrate().
+ */
+typedef enum {
+    TOUCH_CAL_NONE,    /**< Thresholds unchanged */
+    TOUCH_CAL_STORED,  /**< Thresholds calibrated and stored */
+    TOUCH_CAL_CLEARED  /**< Stored thresholds cleared, defaults back in use */
+} touch_cal_t;
+
+/**
+ * @brief   Calibrating the thresholds once, or clearing them on a long hold.
+ *
+ * Holding the electrode for TOUCH_RESET_HOLD_MS clears the stored thresholds
+ * and starts a new calibration. Otherwise, once TOUCH_CAL_PRESSES presses were
+ * measured and nothing is stored yet, thresholds derived from the weakest of
+ * them, never above the defaults, are stored. Blocks while the electrode is
+ * held and writes the flash config store, so it must only be called from a
+ * task, in forward gear.
+ *
+ * @return  What was done to the thresholds.
+ */
+touch_cal_t Touch_Calibrate(void);
+
+/**
+ * @brief   Handing the TSI to its end-of-scan interrupt.
+ *
+ * The given task is notified (vTaskNotifyGiveFromISR) on every debounced press.
+ *
+ * @param   task  Task to notify on a touch.
+ *
+ * @return  Nothing
+ */
+void Touch_Start_Events(TaskHandle_t task);
+
+/**
+ * @brief   TSI end-of-scan interrupt handler.
+ *
+ * @return  Nothing
  */
-int Touch_Scan_LH();
+void TSI0_IRQHandler(void);
 
 #endif /* TOUCH_H_ */
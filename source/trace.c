@@ -0,0 +1,221 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    trace.c
+ * @brief   Scheduler trace ring buffer with Chrome trace export
+ *
+ * This source file contains the trace ring, the table mapping task and queue
+ * handles to the one-byte indices stored in a record, and the JSON dump.
+ * Records are timestamped with the run-time stats clock. In Release the
+ * trace macros are not defined and trace_dump() does nothing.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "trace.h"
+#include "task.h"
+#include "runtime.h"
+#include "fsl_debug_console.h"
+#include "macros.h"
+
+#ifdef DEBUG
+
+#define TRACE_NO_HANDLE (0xFF) // Handle table full
+#define TRACE_CPU_TID   (0)    // Timeline row of the running task
+
+/**
+ * @struct trace_record_t
+ * @brief One event in the ring.
+ */
+typedef struct {
+    uint32_t time;  /**< Run-time stats clock counts */
+    uint8_t event;  /**< trace_event_t */
+    uint8_t task;   /**< Handle index of the running task */
+    uint16_t arg;   /**< Handle index of the object, or the event's value */
+} trace_record_t;
+
+#define TRACE_EVENT_NAME(id, name) name,
+
+static const char *const trace_names[] = { TRACE_EVENTS(TRACE_EVENT_NAME) };
+
+static trace_record_t trace_ring[TRACE_RING_SIZE];
+static uint32_t trace_head;                  /**< Records written since the capture started */
+static void *trace_handles[TRACE_MAX_HANDLES]; /**< Tasks and queues seen so far */
+static volatile uint8_t trace_paused;        /**< Set while the ring is dumped */
+
+/**
+ * @brief Returns the index of a handle, adding it on first sight.
+ *
+ * Called with interrupts masked.
+ */
+static uint8_t trace_handle(void *handle) {
+    uint8_t i;
+
+    for (i = 0; i < TRACE_MAX_HANDLES; i++) {
+        if (trace_handles[i] == handle) {
+            return i;
+        }
+        if (trace_handles[i] == NULL) {
+            trace_handles[i] = handle;
+            return i;
+        }
+    }
+    return TRACE_NO_HANDLE;
+}
+
+/**
+ * @brief Records one event of the running task; called from the trace macros.
+ */
+void trace_event(uint32_t event, void *object, uint32_t value) {
+    uint32_t primask = __get_PRIMASK();
+    trace_record_t *record;
+
+    // Kernel objects are created before the scheduler; only trace it running
+    if (trace_paused || (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)) {
+        return;
+    }
+
+    __disable_irq();
+    record = &trace_ring[trace_head & (TRACE_RING_SIZE - ONE)];
+    trace_head++;
+    record->time = runtime_counter();
+    record->event = (uint8_t)event;
+    record->task = trace_handle(xTaskGetCurrentTaskHandle());
+    record->arg = object ? trace_handle(object) : (uint16_t)value;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Names a task handle index for the timeline.
+ */
+static const char *trace_task_name(uint8_t index) {
+    if (index >= TRACE_MAX_HANDLES || trace_handles[index] == NULL) {
+        return "?";
+    }
+    return pcTaskGetName((TaskHandle_t)trace_handles[index]);
+}
+
+/**
+ * @brief Names a queue handle index for the timeline.
+ */
+static const char *trace_queue_name(uint8_t index) {
+    const char *name;
+
+    if (index >= TRACE_MAX_HANDLES || trace_handles[index] == NULL) {
+        return "?";
+    }
+    name = pcQueueGetName((QueueHandle_t)trace_handles[index]);
+    return name ? name : "queue";
+}
+
+/**
+ * @brief Prints the ring as Chrome trace JSON and starts a new capture.
+ *
+ * The running task is drawn as begin/end slices on the "CPU" row; every other
+ * event is an instant event on the row of the task that caused it, carrying
+ * the task or queue it acted on, or its value.
+ */
+void trace_dump(void) {
+    uint32_t first, count, i;
+    uint32_t start;
+    uint32_t us;
+    trace_record_t r;
+    uint8_t open = ZERO;
+    uint32_t named = ZERO;
+
+    trace_paused = ONE;
+
+    count = (trace_head < TRACE_RING_SIZE) ? trace_head : TRACE_RING_SIZE;
+    first = trace_head - count;
+    start = count ? trace_ring[first & (TRACE_RING_SIZE - ONE)].time : ZERO;
+
+    PRINTF("TRACE,begin\n\r{\"traceEvents\":[\n\r");
+
+    // Row names: the CPU, then one row per task seen
+    PRINTF("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+            "\"args\":{\"name\":\"CPU\"}}", TRACE_CPU_TID);
+    for (i = 0; i < count; i++) {
+        r = trace_ring[(first + i) & (TRACE_RING_SIZE - ONE)];
+        if ((r.event == TRACE_SWITCH_IN) && (r.task != TRACE_NO_HANDLE)
+                && !(named & (ONE << r.task))) {
+            named |= (ONE << r.task);
+            PRINTF(",\n\r{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                    "\"args\":{\"name\":\"%s\"}}", r.task + ONE, trace_task_name(r.task));
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        r = trace_ring[(first + i) & (TRACE_RING_SIZE - ONE)];
+        us = (uint32_t)(((uint64_t)(r.time - start) << RUNTIME_PRESCALE_SHIFT)
+                / (configCPU_CLOCK_HZ / (THOUSAND * THOUSAND)));
+
+        switch (r.event) {
+        case TRACE_SWITCH_IN:
+            PRINTF(",\n\r{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%d,\"pid\":1,\"tid\":%d}",
+                    trace_task_name(r.task), (int)us, TRACE_CPU_TID);
+            open = ONE;
+            break;
+
+        case TRACE_SWITCH_OUT:
+            // The ring may start in the middle of a slice
+            if (open) {
+                PRINTF(",\n\r{\"ph\":\"E\",\"ts\":%d,\"pid\":1,\"tid\":%d}", (int)us,
+                        TRACE_CPU_TID);
+                open = ZERO;
+            }
+            break;
+
+        case TRACE_SUSPEND:
+        case TRACE_RESUME:
+        case TRACE_RESUME_FROM_ISR:
+        case TRACE_NOTIFY:
+        case TRACE_NOTIFY_FROM_ISR:
+            PRINTF(",\n\r{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%d,\"pid\":1,"
+                    "\"tid\":%d,\"args\":{\"task\":\"%s\"}}", trace_names[r.event], (int)us,
+                    r.task + ONE, trace_task_name((uint8_t)r.arg));
+            break;
+
+        case TRACE_QUEUE_SEND:
+        case TRACE_QUEUE_SEND_FROM_ISR:
+        case TRACE_QUEUE_RECEIVE:
+        case TRACE_QUEUE_BLOCK_SEND:
+        case TRACE_QUEUE_BLOCK_RECEIVE:
+            PRINTF(",\n\r{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%d,\"pid\":1,"
+                    "\"tid\":%d,\"args\":{\"queue\":\"%s\"}}", trace_names[r.event], (int)us,
+                    r.task + ONE, trace_queue_name((uint8_t)r.arg));
+            break;
+
+        default:
+            PRINTF(",\n\r{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%d,\"pid\":1,"
+                    "\"tid\":%d,\"args\":{\"value\":%d}}", trace_names[r.event], (int)us,
+                    r.task + ONE, r.arg);
+            break;
+        }
+    }
+
+    PRINTF("\n\r]}\n\rTRACE,end\n\r");
+
+    // Start the next capture from an empty ring
+    trace_head = ZERO;
+    trace_paused = ZERO;
+}
+
+#else
+
+void trace_event(uint32_t event, void *object, uint32_t value) {
+}
+
+void trace_dump(void) {
+}
+
+#endif /* DEBUG */
@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    trace.h
+ * @brief   Scheduler trace ring buffer with Chrome trace export
+ *
+ * This header file declares the scheduler trace of the DEBUG build. The
+ * FreeRTOS trace macros (see FreeRTOSConfig.h) call trace_event(), which
+ * stores a compact timestamped record in a RAM ring, overwriting the oldest.
+ * trace_dump() prints the ring as Chrome trace JSON between TRACE,begin and
+ * TRACE,end lines; save the lines in between to a .json file and open it in
+ * chrome://tracing or ui.perfetto.dev. The "CPU" row shows which task runs,
+ * one row per task shows its delays, queue, notification and event group
+ * calls.
+ *
+ * This header is included by FreeRTOSConfig.h, so it must not include any
+ * FreeRTOS header.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+
+#define TRACE_RING_SIZE   (128) // Records kept, 8 bytes each; a power of two
+#define TRACE_MAX_HANDLES (12)  // Tasks and queues the trace can tell apart
+
+#if (TRACE_RING_SIZE & (TRACE_RING_SIZE - 1))
+#error "TRACE_RING_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief Traced events: identifier and name shown in the timeline.
+ */
+#define TRACE_EVENTS(EVENT) \
+    EVENT(TRACE_SWITCH_IN,        "switch in") \
+    EVENT(TRACE_SWITCH_OUT,       "switch out") \
+    EVENT(TRACE_DELAY,            "delay") \
+    EVENT(TRACE_DELAY_UNTIL,      "delay until") \
+    EVENT(TRACE_SUSPEND,          "suspend") \
+    EVENT(TRACE_RESUME,           "resume") \
+    EVENT(TRACE_RESUME_FROM_ISR,  "resume from ISR") \
+    EVENT(TRACE_QUEUE_SEND,       "queue send") \
+    EVENT(TRACE_QUEUE_SEND_FROM_ISR, "queue send from ISR") \
+    EVENT(TRACE_QUEUE_RECEIVE,    "queue receive") \
+    EVENT(TRACE_QUEUE_BLOCK_SEND, "block on queue send") \
+    EVENT(TRACE_QUEUE_BLOCK_RECEIVE, "block on queue receive") \
+    EVENT(TRACE_NOTIFY,           "notify") \
+    EVENT(TRACE_NOTIFY_FROM_ISR,  "notify from ISR") \
+    EVENT(TRACE_NOTIFY_TAKE,      "notify take") \
+    EVENT(TRACE_NOTIFY_TAKE_BLOCK, "block on notify take") \
+    EVENT(TRACE_NOTIFY_WAIT,      "notify wait") \
+    EVENT(TRACE_NOTIFY_WAIT_BLOCK, "block on notify wait") \
+    EVENT(TRACE_EVENT_SET_BITS,   "event group set") \
+    EVENT(TRACE_EVENT_WAIT_BLOCK, "block on event group")
+
+#define TRACE_EVENT_ID(id, name) id,
+
+/**
+ * @enum trace_event_t
+ * @brief Kind of a trace record.
+ */
+typedef enum {
+    TRACE_EVENTS(TRACE_EVENT_ID)
+    TRACE_EVENT_COUNT
+} trace_event_t;
+
+/**
+ * @brief Records one event of the running task; called from the trace macros.
+ *
+ * Safe in any context, including the PendSV and other interrupt handlers.
+ *
+ * @param event The trace_event_t that happened.
+ * @param object Task or queue the event acts on, or NULL.
+ * @param value Stored instead of the object when object is NULL (event bits).
+ */
+void trace_event(uint32_t event, void *object, uint32_t value);
+
+/**
+ * @brief Prints the ring as Chrome trace JSON and starts a new capture.
+ *
+ * Recording is paused while the dump runs, so the dump does not trace itself.
+ */
+void trace_dump(void);
+
+#endif /* TRACE_H_ */
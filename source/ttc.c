@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    ttc.c
+ * @brief   Closing speed and time-to-collision estimator
+ *
+ * This source file contains the least-squares fit over the sample ring and
+ * the zone escalation driven by its result. Times are taken relative to the
+ * oldest sample in TTC_TIME_UNIT_US steps, so every sum fits 32 bits; only
+ * the final scaling to cm/s needs a 64-bit product.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "ttc.h"
+#include "macros.h"
+
+/**
+ * @brief Forgets the sample history.
+ */
+void ttc_reset(ttc_estimator_t *ttc) {
+    ttc->index = ZERO;
+    ttc->count = ZERO;
+    ttc->speed = ZERO;
+    ttc->ttc = TTC_NONE;
+}
+
+/**
+ * @brief Fits distance = a + b * t to the history and returns -b in cm/s.
+ *
+ * With n samples, b = (n * Stx - St * Sx) / (n * Stt - St * St).
+ */
+static int32_t ttc_fit(const ttc_estimator_t *ttc) {
+    uint8_t oldest = (ttc->index + TTC_HISTORY - ttc->count) % TTC_HISTORY;
+    int32_t n = ttc->count;
+    int32_t st = 0, sx = 0, stt = 0, stx = 0;
+    int32_t num, den;
+    uint8_t i, slot;
+
+    for (i = ZERO; i < ttc->count; i++) {
+        slot = (oldest + i) % TTC_HISTORY;
+        int32_t t = (int32_t)((ttc->timestamp[slot] - ttc->timestamp[oldest]) / TTC_TIME_UNIT_US);
+        int32_t x = ttc->distance[slot];
+
+        st += t;
+        sx += x;
+        stt += t * t;
+        stx += t * x;
+    }
+
+    num = (n * stx) - (st * sx);
+    den = (n * stt) - (st * st);
+    if (den <= 0) {
+        // All samples at the same time unit; no slope to fit
+        return ZERO;
+    }
+
+    // cm per time unit to cm/s, sign flipped so approaching is positive
+    return (int32_t)(((int64_t)-num * (THOUSAND * THOUSAND / TTC_TIME_UNIT_US)) / den);
+}
+
+/**
+ * @brief Adds a sample and re-estimates the closing speed and TTC.
+ */
+uint32_t ttc_update(ttc_estimator_t *ttc, uint32_t timestamp, uint16_t distance) {
+    uint8_t newest = (ttc->index + TTC_HISTORY - ONE) % TTC_HISTORY;
+
+    // A long gap (parked, rejected frames) breaks the line; start over
+    if (ttc->count && ((timestamp - ttc->timestamp[newest]) > TTC_MAX_GAP_US)) {
+        ttc_reset(ttc);
+    }
+
+    ttc->timestamp[ttc->index] = timestamp;
+    ttc->distance[ttc->index] = distance;
+    ttc->index = (ttc->index + ONE) % TTC_HISTORY;
+    if (ttc->count < TTC_HISTORY) {
+        ttc->count++;
+    }
+
+    ttc->speed = (ttc->count >= TTC_MIN_SAMPLES) ? ttc_fit(ttc) : ZERO;
+    if (ttc->speed < TTC_MIN_SPEED_CM_S) {
+        ttc->ttc = TTC_NONE;
+    } else {
+        ttc->ttc = ((uint32_t)distance * THOUSAND) / (uint32_t)ttc->speed;
+    }
+
+    return ttc->ttc;
+}
+
+/**
+ * @brief Picks the zone to show for a classified zone and a TTC.
+ */
+uint8_t ttc_escalate(uint8_t zone, uint32_t ttc) {
+    if (ttc < TTC_CRITICAL_MS) {
+        return ZERO;
+    }
+    if ((ttc < TTC_WARN_MS) && (zone > ZERO)) {
+        return zone - ONE;
+    }
+    return zone;
+}
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    ttc.h
+ * @brief   Closing speed and time-to-collision estimator
+ *
+ * This header file declares the estimator run on every filtered LiDAR
+ * distance. A least-squares line through the last TTC_HISTORY timestamped
+ * distances gives the closing speed; the latest distance divided by it gives
+ * the time to collision (TTC). Only integer arithmetic is used.
+ *
+ * The TTC escalates the zone shown on the LED, so fast approaches are warned
+ * about earlier than the distance alone would, and raises the acquisition
+ * rate to ACQ_FAST_RATE_HZ while a collision is near.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef TTC_H_
+#define TTC_H_
+
+#include <stdint.h>
+
+#define TTC_HISTORY       (8)    // Samples in the least-squares fit
+#define TTC_MIN_SAMPLES   (4)    // Samples needed before a speed is reported
+#define TTC_TIME_UNIT_US  (100)  // Time resolution of the fit
+#define TTC_MAX_GAP_US    (50000) // A longer gap between samples restarts the history
+#define TTC_MIN_SPEED_CM_S (5)   // Slower approaches are treated as standing still
+
+#define TTC_WARN_MS       (2000) // Escalate one zone and sample fast below this TTC
+#define TTC_CRITICAL_MS   (800)  // Show the nearest zone below this TTC
+
+#define TTC_NONE (UINT32_MAX)    // No approach detected
+
+/*
+ * The sums of the fit stay within 32 bits as long as the history spans at
+ * most 3500 time units with distances up to 800 cm.
+ */
+#if ((TTC_HISTORY - 1) * (TTC_MAX_GAP_US / TTC_TIME_UNIT_US)) > 3500
+#error "TTC_HISTORY * TTC_MAX_GAP_US is too long for 32-bit least-squares sums"
+#endif
+#if (TTC_MIN_SAMPLES < 2) || (TTC_MIN_SAMPLES > TTC_HISTORY)
+#error "TTC_MIN_SAMPLES must lie in [2, TTC_HISTORY]"
+#endif
+
+/**
+ * @struct ttc_estimator_t
+ * @brief Sample history and latest output of the estimator.
+ */
+typedef struct {
+    uint32_t timestamp[TTC_HISTORY]; /**< Sample times in microseconds */
+    uint16_t distance[TTC_HISTORY];  /**< Filtered distances in centimetres */
+    uint8_t index;                   /**< Slot to overwrite next */
+    uint8_t count;                   /**< Valid entries */
+    int32_t speed;                   /**< Closing speed in cm/s, negative when receding */
+    uint32_t ttc;                    /**< Time to collision in ms, or TTC_NONE */
+} ttc_estimator_t;
+
+/**
+ * @brief Forgets the sample history.
+ *
+ * @param ttc Estimator state.
+ */
+void ttc_reset(ttc_estimator_t *ttc);
+
+/**
+ * @brief Adds a sample and re-estimates the closing speed and TTC.
+ *
+ * @param ttc Estimator state; speed and ttc are updated.
+ * @param timestamp Time of the sample in microseconds.
+ * @param distance Filtered distance in centimetres.
+ * @return Time to collision in milliseconds, or TTC_NONE.
+ */
+uint32_t ttc_update(ttc_estimator_t *ttc, uint32_t timestamp, uint16_t distance);
+
+/**
+ * @brief Picks the zone to show for a classified zone and a TTC.
+ *
+ * @param zone Zone the distance falls in (index into zone_table).
+ * @param ttc Time to collision in milliseconds, or TTC_NONE.
+ * @return Zone one closer below TTC_WARN_MS, the nearest zone below
+ *         TTC_CRITICAL_MS, else zone unchanged.
+ */
+uint8_t ttc_escalate(uint8_t zone, uint32_t ttc);
+
+#endif /* TTC_H_ */
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    zone.c
+ * @brief   Distance-to-colour zone table
+ *
+ * This source file contains the zone table, generated at compile time from
+ * ZONE_TABLE, together with its binary-search lookup, hysteresis and the
+ * gradient functions used to dim the LED inside a zone.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+
+#include "zone.h"
+#include "led.h"
+#include "macros.h"
+
+#define ZONE_HYSTERESIS (5) // Default hysteresis band in centimetres
+
+static uint8_t gradient_linear(uint16_t distance, const struct zone *zone,
+        uint16_t upper);
+static uint8_t gradient_none(uint16_t distance, const struct zone *zone,
+        uint16_t upper);
+
+/**
+ * @brief Zone definitions, sorted by lower bound; the first must start at 0.
+ *
+ * Columns: lower bound, hysteresis, blink, red/green/blue dim, red/green/blue
+ * mode, gradient. The last zone is unbounded and switches the LED off.
+ */
+#define ZONE_TABLE(ZONE) \
+    ZONE(0,   0,               ONE,  DIM_LED, DIM_LED, DIM_LED, CHANGE_LED,   KEEP_LED_DIM, KEEP_LED_DIM, gradient_linear) \
+    ZONE(90,  ZONE_HYSTERESIS, ZERO, DIM_LED, DIM_LED, DIM_LED, CHANGE_LED,   CHANGE_LED,   KEEP_LED_DIM, gradient_linear) \
+    ZONE(180, ZONE_HYSTERESIS, ZERO, DIM_LED, DIM_LED, DIM_LED, KEEP_LED_DIM, CHANGE_LED,   KEEP_LED_DIM, gradient_linear) \
+    ZONE(720, ZONE_HYSTERESIS, ZERO, DIM_LED, DIM_LED, DIM_LED, KEEP_LED_DIM, KEEP_LED_DIM, KEEP_LED_DIM, gradient_none)
+
+#define ZONE_ENTRY(lower, hyst, blink, r_dim, g_dim, b_dim, r_mode, g_mode, b_mode, gradient) \
+    { lower, hyst, blink, r_dim, g_dim, b_dim, r_mode, g_mode, b_mode, gradient },
+#define ZONE_BOUND(lower, ...) lower,
+#define ZONE_ORDER(lower, ...) lower) && (lower <
+
+// Expands to (0 == b0) && (b0 < b1) && ... && (bn < 0xFFFF)
+#if !((0 == ZONE_TABLE(ZONE_ORDER) 0xFFFF))
+#error "ZONE_TABLE lower bounds must start at 0 and be strictly increasing"
+#endif
+
+const struct zone zone_table[] = { ZONE_TABLE(ZONE_ENTRY) };
+const uint8_t zone_count = sizeof(zone_table) / sizeof(zone_table[0]);
+const uint8_t zone_off = (sizeof(zone_table) / sizeof(zone_table[0])) - ONE;
+
+/**
+ * @brief Lower bounds alone, so the binary search walks a compact array.
+ */
+static const uint16_t zone_bounds[] = { ZONE_TABLE(ZONE_BOUND) };
+
+/**
+ * @brief Ramps from 0 % at the lower bound to 100 % at the upper bound.
+ */
+static uint8_t gradient_linear(uint16_t distance, const struct zone *zone,
+        uint16_t upper) {
+    return ((uint32_t)(distance - zone->lower) * HUNDRED) / (upper - zone->lower);
+}
+
+/**
+ * @brief Constant duty cycle for zones without a gradient.
+ */
+static uint8_t gradient_none(uint16_t distance, const struct zone *zone,
+        uint16_t upper) {
+    return ZERO;
+}
+
+/**
+ * @brief Finds the zone containing a distance by binary search.
+ *
+ * @param distance Distance in centimetres.
+ * @return Index into zone_table; every distance maps to exactly one zone.
+ */
+uint8_t zone_lookup(uint16_t distance) {
+    uint8_t low = 0;
+    uint8_t high = zone_count - ONE;
+
+    // Find the last zone whose lower bound does not exceed the distance
+    while (low < high) {
+        uint8_t mid = (low + high + ONE) / TWO;
+        if (zone_bounds[mid] <= distance) {
+            low = mid;
+        } else {
+            high = mid - ONE;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief Finds the zone for a distance, staying in the current zone until
+ *        the distance clears the boundary's hysteresis band.
+ *
+ * @param distance Distance in centimetres.
+ * @param current Zone currently shown, or ZONE_NONE.
+ * @return Index into zone_table.
+ */
+uint8_t zone_classify(uint16_t distance, uint8_t current) {
+    uint8_t next = zone_lookup(distance);
+
+    if (current >= zone_count || next == current) {
+        return next;
+    }
+
+    if (next > current) {
+        // Moving away: clear the band above the upper boundary
+        if (distance < zone_bounds[current + ONE] + zone_table[current + ONE].hysteresis) {
+            return current;
+        }
+    } else {
+        // Moving closer: clear the band below the lower boundary
+        if (distance + zone_table[current].hysteresis < zone_bounds[current]) {
+            return next;
+        }
+        return current;
+    }
+    return next;
+}
+
+/**
+ * @brief Shows a zone on the RGB LED.
+ *
+ * Hysteresis keeps a zone for distances just outside its bounds, so the
+ * distance is clamped to the zone before it reaches the gradient.
+ *
+ * @param zone Index into zone_table.
+ * @param distance Distance in centimetres, fed to the zone's gradient.
+ * @return Duty cycle percentage applied.
+ */
+uint8_t zone_render(uint8_t zone, uint16_t distance) {
+    const struct zone *z = &zone_table[zone];
+    uint16_t upper = (zone + ONE < zone_count) ? zone_bounds[zone + ONE] : UINT16_MAX;
+    uint8_t percentage;
+
+    if (distance < z->lower) {
+        distance = z->lower;
+    } else if (distance >= upper) {
+        distance = upper - ONE;
+    }
+    percentage = z->gradient(distance, z, upper);
+
+    dim_led(percentage, z->r_dim, z->g_dim, z->b_dim, z->r_mode, z->g_mode,
+            z->b_mode);
+    return percentage;
+}
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (C) 2023 by Jithendra H S
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Jithendra H S and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    zone.h
+ * @brief   Distance-to-colour zone table
+ *
+ * This header file declares the table translating a LiDAR distance into an
+ * LED zone, the lookup with hysteresis and the rendering of a zone on the
+ * RGB LED.
+ *
+ * @author  Jithendra H S
+ * @date    10-17-2026
+ *
+ */
+#ifndef ZONE_H_
+#define ZONE_H_
+
+#include <stdint.h>
+
+#define ZONE_NONE (0xFF) // No zone selected yet
+
+struct zone;
+
+/**
+ * @brief Gradient function turning a distance into a duty cycle percentage.
+ *
+ * @param distance Distance in centimetres, inside the zone.
+ * @param zone The zone the distance falls in.
+ * @param upper Lower bound of the next zone (exclusive upper bound of this one).
+ * @return Duty cycle percentage, 0-100.
+ */
+typedef uint8_t (*zone_gradient_t)(uint16_t distance, const struct zone *zone,
+        uint16_t upper);
+
+/**
+ * @struct zone
+ * @brief One distance zone and the LED settings used to render it.
+ *
+ * A zone covers [lower, lower of the next zone); the last zone is unbounded.
+ */
+struct zone {
+    uint16_t lower;           /**< Inclusive lower bound in centimetres */
+    uint16_t hysteresis;      /**< Band around lower a distance must clear to cross it */
+    uint8_t blink;            /**< Blink the LED in this zone */
+    uint8_t r_dim;            /**< Red LED dim status */
+    uint8_t g_dim;            /**< Green LED dim status */
+    uint8_t b_dim;            /**< Blue LED dim status */
+    uint8_t r_mode;           /**< Red LED mode */
+    uint8_t g_mode;           /**< Green LED mode */
+    uint8_t b_mode;           /**< Blue LED mode */
+    zone_gradient_t gradient; /**< Duty cycle as a function of distance */
+};
+
+extern const struct zone zone_table[]; /**< Zones sorted by lower bound. */
+extern const uint8_t zone_count;       /**< Number of entries in zone_table. */
+extern const uint8_t zone_off;         /**< Zone rendering the LED off. */
+
+/**
+ * @brief Finds the zone containing a distance by binary search.
+ *
+ * @param distance Distance in centimetres.
+ * @return Index into zone_table; every distance maps to exactly one zone.
+ */
+uint8_t zone_lookup(uint16_t distance);
+
+/**
+ * @brief Finds the zone for a distance, staying in the current zone until
+ *        the distance clears the boundary's hysteresis band.
+ *
+ * @param distance Distance in centimetres.
+ * @param current Zone currently shown, or ZONE_NONE.
+ * @return Index into zone_table.
+ */
+uint8_t zone_classify(uint16_t distance, uint8_t current);
+
+/**
+ * @brief Shows a zone on the RGB LED.
+ *
+ * @param zone Index into zone_table.
+ * @param distance Distance in centimetres, fed to the zone's gradient.
+ * @return Duty cycle percentage applied.
+ */
+uint8_t zone_render(uint8_t zone, uint16_t distance);
+
+#endif /* ZONE_H_ */